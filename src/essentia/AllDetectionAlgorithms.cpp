@@ -24,12 +24,18 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
+#include <functional>
 
-#include "loader/StreamAudioLoader.h"
 #include "loader/StreamEasyLoader.h"
-#include "loader/EasyLoader.h"
 #include "loader/StreamEqloudLoader.h"
 #include "standard/StreamStereoTrimmer.h"
+#include "standard/StreamRunningRMS.h"
+#include "standard/StreamTonalPeaks.h"
+#include "standard/FrameStatistics.h"
+#include "standard/FrameStore.h"
+#include "standard/WrapperAlgorithms.h"
+#include "writer/OutputWriter.h"
 
 #include "algorithmfactory.h"
 #include "essentiamath.h"
@@ -53,24 +59,54 @@ using namespace essentia::scheduler;
 
 namespace essentiawrapper {
 
-void compute(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const Pool &options);
-void computeSegments(Pool &neqloudPool, Pool &eqloudPool, const Pool &options);
-void computeReplayGain(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const Pool &options, bool skipCalc);
-void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const Pool &options, Real startTime, Real endTime, const string &nspace = "");
-void computeMidLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const Pool &options, Real startTime, Real endTime, const string &nspace = "");
-void computePanning(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const Pool &options, Real startTime, Real endTime, const string &nspace = "");
-void computeFades(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const Pool &options, Real startTime, Real endTime, const string &nspace = "");
-void computeHighlevel(Pool &pool, const Pool &options, const string &nspace = "");
+void compute(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, shared_ptr<Pool> &neqloudResults, shared_ptr<Pool> &eqloudResults, const AnalysisOptions &options, AnalysisPlan *plan);
+void computeSegments(Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options, const FrameStore &frameStore);
+shared_ptr<Pool> aggregateResults(Pool &pool, const AnalysisOptions &options, size_t segments, bool svm, const DescriptorStatistics &frameStats, const FrameStore &frameStore);
+void writeResults(const shared_ptr<Pool> &results, const string &filename, const AnalysisOptions &options);
+void computeReplayGain(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options, bool skipCalc, AnalysisPlan *plan = nullptr);
+void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options, TonalPeaks &tonalPeaks, DescriptorStatistics &frameStats, FrameStore &frameStore, Real startTime, Real endTime, const string &nspace = "", AnalysisPlan *plan = nullptr);
+void computeTonal(Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options, const TonalPeaks &tonalPeaks, DescriptorStatistics &frameStats, DescriptorMeans &tuningMeans, const string &nspace = "", AnalysisPlan *plan = nullptr);
+void computeMidLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options, Real startTime, Real endTime, const string &nspace = "", AnalysisPlan *plan = nullptr);
+void buildPanning(SourceBase &stereo, Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options, const string &nspace);
+void computeFades(Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options, const string &nspace = "");
+void computeHighlevel(Pool &pool, const DescriptorMeans &tuningMeans, const AnalysisOptions &options, const string &nspace = "");
 void addSVMDescriptors(Pool &pool);
 
-AllDetectionAlgorithms::AllDetectionAlgorithms()
+namespace {
+
+// essentia::init() and essentia::shutdown() are process wide, but plans can
+// outlive a single analysis, so only the last instance shuts essentia down
+mutex essentiaInitMutex;
+int essentiaInitCount = 0;
+
+}
+
+AllDetectionAlgorithms::AllDetectionAlgorithms() : _analyzed(false)
 {
-    essentia::init();
+    lock_guard<mutex> lock(essentiaInitMutex);
+    if (essentiaInitCount++ == 0)
+    {
+        essentia::init();
+        registerWrapperAlgorithms();
+    }
 }
 
 AllDetectionAlgorithms::~AllDetectionAlgorithms()
 {
-    essentia::shutdown();
+    // the cached networks must be deleted while essentia is still initialized
+    _plan.reset();
+
+    lock_guard<mutex> lock(essentiaInitMutex);
+    if (--essentiaInitCount == 0)
+    {
+        essentia::shutdown();
+    }
+}
+
+void AllDetectionAlgorithms::compile(const Pool &config)
+{
+    _plan.reset();
+    _plan.reset(new AnalysisPlan(config));
 }
 
 /**
@@ -81,38 +117,45 @@ AllDetectionAlgorithms::~AllDetectionAlgorithms()
  */
 void AllDetectionAlgorithms::analyze(callbacks *cb, const Pool &config)
 {
-    Pool tmpOptions = config;
-    Pool mergedOptions;
-
-    setDefaultOptions(mergedOptions);
-
-    mergedOptions.merge(tmpOptions, "replace");
+    compile(config);
+    analyze(cb);
+}
 
-    // beat detection needed if beatsloudness or bpmhistogram detection is requested
-    if (mergedOptions.value<Real>("rhythm.beats.loudness.compute") != 0 ||
-            mergedOptions.value<Real>("rhythm.bpmhistogram.compute") != 0)
+void AllDetectionAlgorithms::analyze(callbacks *cb)
+{
+    if (!_plan)
     {
-        mergedOptions.set("rhythm.beats.compute", true);
+        throw EssentiaException("AllDetectionAlgorithms: no analysis plan compiled");
     }
 
-    if (mergedOptions.value<Real>("segmentation.desc.rhythm.beats.loudness.compute") != 0 ||
-            mergedOptions.value<Real>("segmentation.desc.rhythm.bpmhistogram.compute") != 0)
-    {
-        mergedOptions.set("segmentation.desc.rhythm.beats.compute", true);
-    }
+    _neqloudPool.clear();
+    _eqloudPool.clear();
 
-    bool neqloud = mergedOptions.value<Real>("nequalLoudness") != 0;
-    bool eqloud =  mergedOptions.value<Real>("equalLoudness")  != 0;
+    // the results of the previous file may still be held by a handle
+    _neqloudResults.reset();
+    _eqloudResults.reset();
+    _analyzed = false;
 
-    if ((!eqloud && !neqloud) || (eqloud && neqloud))
-    {
-        throw EssentiaException("Configuration for both equal loudness and non\
-           equal loudness is set to false or true. At least and only one must be set to true");
-    }
+    // the containers of the analysis take their memory from the arena, the
+    // plan drops the ones kept from the last file before it is rewound
+    ArenaScope arenaScope(_arena);
+    _plan->clearFrames();
+    _arena.reset();
 
     cout << "-------- start processing --------" << endl;
 
-    compute(cb, _neqloudPool, _eqloudPool, mergedOptions);
+    try
+    {
+        compute(_plan->bind(cb), _neqloudPool, _eqloudPool, _neqloudResults, _eqloudResults, _plan->options(), _plan.get());
+    }
+    catch (...)
+    {
+        _plan->unbind();
+        throw;
+    }
+
+    _plan->unbind();
+    _analyzed = true;
 
     cout << "-------- finished processing --------" << endl;
 
@@ -130,34 +173,73 @@ std::vector<float> AllDetectionAlgorithms::get(const string &configName, bool eq
     }
 }
 
-void compute(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const Pool &options)
+size_t AllDetectionAlgorithms::copy(const string &configName, bool eqLoudPool, float *buffer, size_t capacity)
+{
+    return copyResult(eqLoudPool ? _eqloudPool : _neqloudPool, configName, buffer, capacity);
+}
+
+shared_ptr<const Pool> AllDetectionAlgorithms::results(bool eqLoudPool)
 {
+    if (!_analyzed)
+    {
+        return nullptr;
+    }
 
-    bool neqloud = options.value<Real>("nequalLoudness") != 0;
-    bool eqloud = options.value<Real>("equalLoudness") != 0;
+    const AnalysisOptions &options = _plan->options();
+    if (!(eqLoudPool ? options.equalLoudness : options.nequalLoudness))
+    {
+        return nullptr;
+    }
+
+    // aggregated on the first request, unless the output file needed it
+    shared_ptr<Pool> &results = eqLoudPool ? _eqloudResults : _neqloudResults;
+    if (!results)
+    {
+        size_t segments = 0;
+        if (options.trackPasses.runs(StageSegmentation))
+        {
+            segments = _eqloudPool.value<vector<Real> >("segmentation.timestamps").size();
+        }
+
+        results = aggregateResults(eqLoudPool ? _eqloudPool : _neqloudPool, options, segments,
+                                   eqLoudPool && options.svm, _plan->frameStats, _plan->frameStore);
+    }
+
+    return results;
+}
+
+// Returns the network of a pass, building it on first use. A network that
+// already ran is reset, so it can process the next file.
+Network *preparePass(unique_ptr<Network> &network, const function<Algorithm *()> &build)
+{
+    if (network)
+    {
+        network->reset();
+    }
+    else
+    {
+        network.reset(new Network(build()));
+    }
+
+    return network.get();
+}
+
+void compute(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, shared_ptr<Pool> &neqloudResults, shared_ptr<Pool> &eqloudResults, const AnalysisOptions &options, AnalysisPlan *plan)
+{
+
+    bool neqloud = options.nequalLoudness;
+    bool eqloud = options.equalLoudness;
 
     if (neqloud) neqloudPool.set("metadata.audio_properties.equal_loudness", false);
     if (eqloud) eqloudPool.set("metadata.audio_properties.equal_loudness", true);
 
-    // what to compute:
-
-    bool lowlevel = options.value<Real>("lowlevel.compute")             ||
-                    options.value<Real>("average_loudness.compute")     ||
-                    options.value<Real>("tonal.compute")                ||
-                    options.value<Real>("sfx.compute")                  ||
-                    options.value<Real>("rhythm.beats.compute")         ||
-                    options.value<Real>("rhythm.onset.compute")         ||
-                    options.value<Real>("rhythm.danceability.compute")  ||
-                    options.value<Real>("segmentation.compute") != 0;
-    bool midlevel = options.value<Real>("tonal.compute") ||
-                    options.value<Real>("rhythm.beats.loudness.compute");
-    bool panning  = options.value<Real>("panning.compute") != 0;
-    bool fades    = options.value<Real>("fades.compute") != 0;
+    // what to compute, only the passes the requested descriptors depend on:
+    const PassSchedule &passes = options.trackPasses;
 
     // compute features for the whole song
-    computeReplayGain(cb, neqloudPool, eqloudPool, options, options.value<Real>("skipReplayGain"));
-    Real startTime = options.value<Real>("startTime");
-    Real endTime = options.value<Real>("endTime");
+    computeReplayGain(cb, neqloudPool, eqloudPool, options, options.skipReplayGain, plan);
+    Real startTime = options.startTime;
+    Real endTime = options.endTime;
     if (eqloud)
     {
         if (endTime > eqloudPool.value<Real>("metadata.audio_properties.length"))
@@ -173,29 +255,38 @@ void compute(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const Poo
             endTime = neqloudPool.value<Real>("metadata.audio_properties.length");
         }
     }
-    if (lowlevel) computeLowLevel(cb, neqloudPool, eqloudPool, options, startTime, endTime);
-    if (midlevel) computeMidLevel(cb, neqloudPool, eqloudPool, options, startTime, endTime);
-    if (panning) computePanning(cb, neqloudPool, eqloudPool, options, startTime, endTime);
-    if (fades) computeFades(cb, neqloudPool, eqloudPool, options, startTime, endTime);
-    if (neqloud) computeHighlevel(neqloudPool, options);
-    if (eqloud) computeHighlevel(eqloudPool, options);
-
-    bool segLowlevel = options.value<Real>("segmentation.desc.lowlevel.compute")         ||
-                       options.value<Real>("segmentation.desc.average_loudness.compute") ||
-                       options.value<Real>("segmentation.desc.tonal.compute")            ||
-                       options.value<Real>("segmentation.desc.sfx.compute")              ||
-                       options.value<Real>("segmentation.desc.rhythm.beats.compute")     ||
-                       options.value<Real>("segmentation.desc.rhythm.onset.compute")     ||
-                       options.value<Real>("segmentation.desc.rhythm.danceability.compute");
-    bool segMidlevel = options.value<Real>("segmentation.desc.tonal.compute") ||
-                       options.value<Real>("segmentation.desc.rhythm.beats.loudness.compute");
-    bool segPanning  = options.value<Real>("segmentation.desc.panning.compute") != 0;
-    bool segFades    = options.value<Real>("segmentation.desc.fades.compute") != 0;
+    // the tonal peaks of the low level pass, kept until the tonal pass
+    TonalPeaks localPeaks;
+    TonalPeaks &tonalPeaks = plan ? plan->tonalPeaks : localPeaks;
+
+    // the statistics of the frame descriptors aggregated while streaming
+    DescriptorStatistics localStats;
+    DescriptorStatistics &frameStats = plan ? plan->frameStats : localStats;
+    frameStats.clear();
+
+    // the frames of the vector descriptors that are not aggregated while
+    // streaming, exported to the pools for the aggregation
+    FrameStore localFrames;
+    FrameStore &frameStore = plan ? plan->frameStore : localFrames;
+    frameStore.clear();
+
+    // the means of the HPCP, for the tuning system features
+    DescriptorMeans localMeans;
+    DescriptorMeans &tuningMeans = plan ? plan->tuningMeans : localMeans;
+    tuningMeans.clear();
+
+    if (passes.runs(PassLowLevel)) computeLowLevel(cb, neqloudPool, eqloudPool, options, tonalPeaks, frameStats, frameStore, startTime, endTime, "", plan);
+    if (passes.runs(PassTonal)) computeTonal(neqloudPool, eqloudPool, options, tonalPeaks, frameStats, tuningMeans, "", plan);
+    if (passes.runs(PassMidLevel)) computeMidLevel(cb, neqloudPool, eqloudPool, options, startTime, endTime, "", plan);
+    if (neqloud) computeHighlevel(neqloudPool, tuningMeans, options);
+    if (eqloud) computeHighlevel(eqloudPool, tuningMeans, options);
+
+    const PassSchedule &segPasses = options.segmentPasses;
 
     vector<Real> segments;
-    if (options.value<Real>("segmentation.compute") != 0)
+    if (passes.runs(StageSegmentation))
     {
-        computeSegments(neqloudPool, eqloudPool, options);
+        computeSegments(neqloudPool, eqloudPool, options, frameStore);
 
         segments = eqloudPool.value<vector<Real> >("segmentation.timestamps");
         for (int i = 0; i < int(segments.size() - 1); ++i)
@@ -207,90 +298,97 @@ void compute(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const Poo
             cout << "\n**************************************************************************" << endl;
 
             // set segment name
-            ostringstream ns;
-            ns << "segment_" << i;
-            string sn = ns.str();
-            ns.str("");
-            ns << "segments." << sn << ".name";
-            if (neqloud) neqloudPool.set(ns.str(), sn);
-            if (eqloud) eqloudPool.set(ns.str(), sn);
+            string sn = "segment_" + to_string(i);
+            string segment = "segments." + sn;
+            if (neqloud) neqloudPool.set(segment + ".name", sn);
+            if (eqloud) eqloudPool.set(segment + ".name", sn);
 
             // set segment scope
-            ns.str("");
-            ns << "segments." << sn << ".scope";
             vector<Real> scope(2, 0);
             scope[0] = start;
             scope[1] = end;
-            if (neqloud) neqloudPool.set(ns.str(), scope);
-            if (eqloud) eqloudPool.set(ns.str(), scope);
+            if (neqloud) neqloudPool.set(segment + ".scope", scope);
+            if (eqloud) eqloudPool.set(segment + ".scope", scope);
 
             // compute descriptors
-            ns.str("");
-            ns << "segments.segment_" << i << ".desc";
+            string ns = segment + ".desc";
 
-            if (segLowlevel) computeLowLevel(cb, neqloudPool, eqloudPool, options, start, end, ns.str());
-            if (segMidlevel) computeMidLevel(cb, neqloudPool, eqloudPool, options, start, end, ns.str());
-            if (segPanning) computePanning(cb, neqloudPool, eqloudPool, options, start, end, ns.str());
-            if (segFades) computeFades(cb, neqloudPool, eqloudPool, options, start, end, ns.str());
-            if (neqloud) computeHighlevel(neqloudPool, options, ns.str());
-            if (eqloud) computeHighlevel(eqloudPool, options, ns.str());
+            if (segPasses.runs(PassLowLevel)) computeLowLevel(cb, neqloudPool, eqloudPool, options, tonalPeaks, frameStats, frameStore, start, end, ns);
+            if (segPasses.runs(PassTonal)) computeTonal(neqloudPool, eqloudPool, options, tonalPeaks, frameStats, tuningMeans, ns);
+            if (segPasses.runs(PassMidLevel)) computeMidLevel(cb, neqloudPool, eqloudPool, options, start, end, ns);
+            if (neqloud) computeHighlevel(neqloudPool, tuningMeans, options, ns);
+            if (eqloud) computeHighlevel(eqloudPool, tuningMeans, options, ns);
 
             cout << "\n**************************************************************************\n";
         }
     }
 
-    if (neqloud)
+    // the aggregation is only needed for the output files here, the result
+    // handles aggregate on request
+    if (neqloud && !options.nequalOutputPath.empty())
     {
-        Pool stats = computeAggregation(neqloudPool, options, segments.size());
-        //if (options.value<Real>("svm.compute") != 0) addSVMDescriptors(stats); //not available
-        cleanUp(stats, options);
-        outputToFile(stats, options.value<string>("nequalOutputPath"), options);
-        neqloudPool.remove("metadata.audio_properties.downmix");
+        neqloudResults = aggregateResults(neqloudPool, options, segments.size(), false, frameStats, frameStore);
+        writeResults(neqloudResults, options.nequalOutputPath, options);
     }
 
-    if (eqloud)
+    if (eqloud && !options.equalOutputPath.empty())
     {
-        Pool stats = computeAggregation(eqloudPool, options, segments.size());
-        if (options.value<Real>("svm.compute") != 0) addSVMDescriptors(stats);
-        cleanUp(stats, options);
-        outputToFile(stats, options.value<string>("equalOutputPath"), options);
-        eqloudPool.remove("metadata.audio_properties.downmix");
+        eqloudResults = aggregateResults(eqloudPool, options, segments.size(), options.svm, frameStats, frameStore);
+        writeResults(eqloudResults, options.equalOutputPath, options);
     }
 }
 
-void computeSegments(Pool &neqloudPool, Pool &eqloudPool, const Pool &options)
+shared_ptr<Pool> aggregateResults(Pool &pool, const AnalysisOptions &options, size_t segments, bool svm, const DescriptorStatistics &frameStats, const FrameStore &frameStore)
 {
+    frameStore.exportTo(pool);
 
-    bool neqloud = options.value<Real>("nequalLoudness") != 0;
-    bool eqloud =  options.value<Real>("equalLoudness")  != 0;
+    // the pool is not copied
+    shared_ptr<Pool> stats(new Pool(computeAggregation(pool, options, segments, &frameStats)));
+    if (svm) addSVMDescriptors(*stats);
+    cleanUp(*stats, options);
 
-    int minimumSegmentsLength = int(options.value<Real>("segmentation.minimumSegmentsLength"));
-    int size1 = int(options.value<Real>("segmentation.size1"));
-    int inc1  = int(options.value<Real>("segmentation.inc1"));
-    int size2 = int(options.value<Real>("segmentation.size2"));
-    int inc2  = int(options.value<Real>("segmentation.inc2"));
-    int cpw   = int(options.value<Real>("segmentation.cpw"));
+    pool.remove("metadata.audio_properties.downmix");
 
-    vector<vector<Real> > features;
-    try
+    return stats;
+}
+
+void writeResults(const shared_ptr<Pool> &results, const string &filename, const AnalysisOptions &options)
+{
+    if (!options.outputAsync)
     {
-        if (neqloud) features = neqloudPool.value<vector<vector<Real> > >("lowlevel.mfcc");
-        if (eqloud) features = eqloudPool.value<vector<vector<Real> > >("lowlevel.mfcc");
+        outputToFile(*results, filename, options);
+        return;
     }
-    catch (const EssentiaException &)
+
+    // the pool is final before it is queued, the result handles may read it
+    // while it is written
+    prepareOutput(*results, options);
+    OutputWriter::instance().write(results, filename, options.outputFormat);
+}
+
+void computeSegments(Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options, const FrameStore &frameStore)
+{
+
+    bool neqloud = options.nequalLoudness;
+    bool eqloud =  options.equalLoudness;
+
+    int minimumSegmentsLength = options.segmentation.minimumSegmentsLength;
+    int size1 = options.segmentation.size1;
+    int inc1  = options.segmentation.inc1;
+    int size2 = options.segmentation.size2;
+    int inc2  = options.segmentation.inc2;
+    int cpw   = int(options.segmentation.cpw);
+
+    // the MFCC of the low level pass are in the frame store
+    DescriptorId mfccId = DescriptorRegistry::instance().intern("lowlevel.mfcc");
+    const FrameMatrix *features = frameStore.find(eqloud ? eqloudPool : neqloudPool, mfccId);
+    if (!features || features->frames() == 0)
     {
         cerr << "Error: could not find MFCC features in low level pool. Aborting..." << endl;
         exit(3);
     }
 
-    TNT::Array2D<Real> featuresArray(features[0].size(), features.size());
-    for (int frame = 0; frame < int(features.size()); ++frame)
-    {
-        for (int mfcc = 0; mfcc < int(features[0].size()); ++mfcc)
-        {
-            featuresArray[mfcc][frame] = features[frame][mfcc];
-        }
-    }
+    TNT::Array2D<Real> featuresArray = features->transposed();
     // only BIC segmentation available
     standard::Algorithm *sbic = standard::AlgorithmFactory::create("SBic", "size1", size1, "inc1", inc1,
                                 "size2", size2, "inc2", inc2, "cpw", cpw,
@@ -299,8 +397,8 @@ void computeSegments(Pool &neqloudPool, Pool &eqloudPool, const Pool &options)
     sbic->input("features").set(featuresArray);
     sbic->output("segmentation").set(segments);
     sbic->compute();
-    Real analysisSampleRate = options.value<Real>("analysisSampleRate");
-    Real step = options.value<Real>("lowlevel.hopSize");
+    Real analysisSampleRate = options.analysisSampleRate;
+    Real step = options.lowlevel.hopSize;
 
     for (int i = 0; i < int(segments.size()); ++i)
     {
@@ -310,17 +408,39 @@ void computeSegments(Pool &neqloudPool, Pool &eqloudPool, const Pool &options)
     }
 }
 
+Algorithm *buildReplayGain(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options)
+{
+    bool neqloud = options.nequalLoudness;
+    bool eqloud =  options.equalLoudness;
+
+    streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
+
+    Algorithm *streamEqloudloader = new StreamEqloudLoader(cb);
+    streamEqloudloader->declareParameters();
+
+    Algorithm *rgain   = factory.create("ReplayGain",
+                                        "applyEqloud", false);
+
+    streamEqloudloader->output("audio")  >>  rgain->input("signal");
+    if (neqloud)
+        rgain->output("replayGain")  >>  PC(neqloudPool, "metadata.audio_properties.replay_gain");
+    if (eqloud)
+        rgain->output("replayGain")  >>  PC(eqloudPool, "metadata.audio_properties.replay_gain");
+
+    return streamEqloudloader;
+}
+
 void computeReplayGain(const callbacks *cb, Pool &neqloudPool,
-                       Pool &eqloudPool, const Pool &options, bool skipCalc)
+                       Pool &eqloudPool, const AnalysisOptions &options, bool skipCalc, AnalysisPlan *plan)
 {
 
-    bool neqloud = options.value<Real>("nequalLoudness") != 0;
-    bool eqloud =  options.value<Real>("equalLoudness")  != 0;
+    bool neqloud = options.nequalLoudness;
+    bool eqloud =  options.equalLoudness;
 
-    Real analysisSampleRate = options.value<Real>("analysisSampleRate");
+    Real analysisSampleRate = options.analysisSampleRate;
 
-    Real startTime = options.value<Real>("startTime");
-    Real endTime = options.value<Real>("endTime");
+    Real startTime = options.startTime;
+    Real endTime = options.endTime;
 
     if (skipCalc)
     {
@@ -350,8 +470,6 @@ void computeReplayGain(const callbacks *cb, Pool &neqloudPool,
     }
     else
     {
-        streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
-
         /*************************************************************************
          *    1st pass: get some metadata and replay gain                        *
          *************************************************************************/
@@ -366,16 +484,18 @@ void computeReplayGain(const callbacks *cb, Pool &neqloudPool,
         while (tryReallyHard)
         {
 
-            Algorithm *streamEqloudloader = new StreamEqloudLoader(cb);
-            streamEqloudloader->declareParameters();
+            unique_ptr<Network> localNetwork;
+            Network *network = preparePass(plan ? plan->replayGain : localNetwork, [&]()
+            {
+                return buildReplayGain(cb, neqloudPool, eqloudPool, options);
+            });
+
+            Algorithm *streamEqloudloader = network->visibleNetworkRoot()->algorithm();
             streamEqloudloader->configure("sampleRate", analysisSampleRate,
                                           "startTime",  startTime,
                                           "endTime",    endTime,
                                           "downmix",    downmix);
 
-            Algorithm *rgain   = factory.create("ReplayGain",
-                                                "applyEqloud", false);
-
             if (neqloud)
             {
                 neqloudPool.set("metadata.audio_properties.analysis_sample_rate", streamEqloudloader->parameter("sampleRate").toReal());
@@ -387,17 +507,10 @@ void computeReplayGain(const callbacks *cb, Pool &neqloudPool,
                 eqloudPool.set("metadata.audio_properties.downmix", downmix);
             }
 
-            streamEqloudloader->output("audio")  >>  rgain->input("signal");
-            if (neqloud)
-                rgain->output("replayGain")  >>  PC(neqloudPool, "metadata.audio_properties.replay_gain");
-            if (eqloud)
-                rgain->output("replayGain")  >>  PC(eqloudPool, "metadata.audio_properties.replay_gain");
-
             cout << "Process step 1: Replay Gain" << endl;
             try
             {
-                Network network(streamEqloudloader);
-                network.run();
+                network->run();
                 length = streamEqloudloader->output("audio").totalProduced();
                 tryReallyHard = false;
             }
@@ -461,89 +574,92 @@ void computeReplayGain(const callbacks *cb, Pool &neqloudPool,
 
 }
 
-void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
-                     const Pool &options, Real startTime, Real endTime, const string &nspace)
+Algorithm *buildLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
+                        const AnalysisOptions &options, TonalPeaks &tonalPeaks,
+                        DescriptorStatistics &frameStats, FrameStore &frameStore, const string &nspace)
 {
-    /*************************************************************************
-     *    2nd pass: normalize the audio with replay gain, compute as         *
-     *              many lowlevel descriptors as possible                    *
-     *************************************************************************/
-
-    cout << "Process step 2: Low Level" << endl;
-
     // namespace:
-    string llspace = "lowlevel.";
     string rhythmspace = "rhythm.";
     if (!nspace.empty())
     {
-        llspace = nspace + ".lowlevel.";
         rhythmspace = nspace + ".rhythm.";
     }
 
-    Real analysisSampleRate = options.value<Real>("analysisSampleRate");
-    Real replayGain = 0;
-    string downmix = "mix";
+    bool neqloud = options.nequalLoudness;
+    bool eqloud  = options.equalLoudness;
 
-    bool neqloud = options.value<Real>("nequalLoudness") != 0;
-    bool eqloud  = options.value<Real>("equalLoudness")  != 0;
+    const PassSchedule &passes = options.passes(nspace);
 
-    bool doLowLevelSpectral = options.value<Real>("lowlevel.compute") != 0 ||
-                              options.value<Real>("segmentation.desc.lowlevel.compute") != 0 ||
-                              options.value<Real>("segmentation.compute") != 0;
+    bool doLowLevelSpectral = passes.runs(StageLowLevelSpectral);
 
-    bool computeAverageLoudness = nspace.empty() ?
-                                  options.value<Real>("average_loudness.compute") != 0 :
-                                  options.value<Real>("segmentation.desc.average_loudness.compute") != 0;
+    bool doLowLevelSpectralEqLoud = passes.runs(StageLowLevelSpectralEqLoud);
 
-    bool computeTonal = nspace.empty() ?
-                        options.value<Real>("tonal.compute") != 0 :
-                        options.value<Real>("segmentation.desc.tonal.compute") != 0;
+    bool computeAverageLoudness = passes.runs(StageLevel);
 
-    bool computeBeats = nspace.empty() ?
-                        options.value<Real>("rhythm.beats.compute") != 0 :
-                        options.value<Real>("segmentation.desc.rhythm.beats.compute") != 0;
+    bool computeTonal = passes.runs(StageTuningFrequency);
 
-    if (eqloud)
-    {
-        replayGain = eqloudPool.value<Real>("metadata.audio_properties.replay_gain");
-        downmix = eqloudPool.value<string>("metadata.audio_properties.downmix");
-    }
-    if (neqloud)
-    {
-        replayGain = neqloudPool.value<Real>("metadata.audio_properties.replay_gain");
-        downmix = neqloudPool.value<string>("metadata.audio_properties.downmix");
-    }
+    // the tonal pass runs on the peaks of the tuning frequency
+    TonalPeaks *peaksStore = passes.runs(StageTonalDescriptors) ? &tonalPeaks : nullptr;
+
+    // the spectral descriptors are only stored frame by frame if one of
+    // their statistics needs all the frames
+    bool streamStats = FrameStatistics::supports(options.stats.lowlevel) &&
+                       FrameStatistics::supports(options.stats.mfcc);
+    DescriptorStatistics *statsStore = streamStats ? &frameStats : nullptr;
+
+    bool computeBeats = passes.runs(StageRhythm);
+
+    bool computePanning = passes.runs(StagePanning);
 
     streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
 
-    Algorithm *streamEasyLoader = new StreamEasyLoader(cb);
+    // the panning reads the stereo signal of the same decode
+    Algorithm *streamEasyLoader = new StreamEasyLoader(cb, computePanning);
     streamEasyLoader->declareParameters();
-    streamEasyLoader->configure("sampleRate", analysisSampleRate,
-                                "startTime",  startTime,
-                                "endTime",    endTime,
-                                "replayGain", replayGain,
-                                "downmix",    downmix);
 
     Algorithm *eqloudnesser = factory.create("EqualLoudness");
-    if(eqloud || doLowLevelSpectral || computeAverageLoudness)
+    if(eqloud || doLowLevelSpectralEqLoud || computeAverageLoudness)
     {
         connect(streamEasyLoader->output("audio"), eqloudnesser->input("signal"));
     }
     SourceBase &neqloudSource = streamEasyLoader->output("audio");
     SourceBase &eqloudSource = eqloudnesser->output("signal");
 
+    // the extractors reading the same source with the same framing share
+    // one FrameCutter, Windowing and Spectrum
+    SpectralFrontEnd frontEnd;
+
+    // Fades, the RMS of the frames is kept until the end of the pass, see
+    // computeFades()
+    if (passes.runs(StageFades))
+    {
+        string fadesspace = "fades.";
+        if (!nspace.empty()) fadesspace = nspace + ".fades.";
+
+        Algorithm *rms = new StreamRunningRMS();
+        rms->declareParameters();
+        rms->configure("frameSize", options.fades.frameSize,
+                       "hopSize",   options.fades.hopSize);
+        connect(neqloudSource, rms->input("signal"));
+        connect(rms->output("rms"), eqloud ? eqloudPool : neqloudPool, fadesspace + "rms");
+    }
+
+    if (computePanning)
+    {
+        buildPanning(streamEasyLoader->output("stereo"), neqloudPool, eqloudPool, options, nspace);
+    }
+
     if (neqloud)
     {
 
         if (doLowLevelSpectral)
-        {
-            LowLevelSpectral(neqloudSource, neqloudPool, options, nspace);
+            LowLevelSpectral(neqloudSource, frontEnd, neqloudPool, statsStore, &frameStore, options, nspace);
 
-            // Low-Level Spectral Equal Loudness Descriptors
-            // expects the audio source to already be equal-loudness filtered, so it
-            // must use the eqloudSouce instead of neqloudSource
-            LowLevelSpectralEqLoud(eqloudSource, neqloudPool, options, nspace);
-        }
+        // Low-Level Spectral Equal Loudness Descriptors
+        // expects the audio source to already be equal-loudness filtered, so it
+        // must use the eqloudSouce instead of neqloudSource
+        if (doLowLevelSpectralEqLoud)
+            LowLevelSpectralEqLoud(eqloudSource, frontEnd, neqloudPool, statsStore, &frameStore, options, nspace);
 
         // Level Descriptor
         // expects the audio source to already be equal-loudness filtered, so it
@@ -554,16 +670,16 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
 
         // Tuning Frequency
         if (computeTonal)
-            TuningFrequency(neqloudSource, neqloudPool, options, nspace);
+            TuningFrequency(neqloudSource, frontEnd, peaksStore, neqloudPool, options, nspace);
 
         // Rhythm descriptor - beats
         if (computeBeats)
         {
 
             Algorithm *rhythmExtractor = factory.create("RhythmExtractor2013");
-            rhythmExtractor->configure("method", options.value<string>("rhythm.beats.method"),
-                                       "maxTempo", options.value<Real>("rhythm.beats.maxTempo"),
-                                       "minTempo", options.value<Real>("rhythm.beats.minTempo"));
+            rhythmExtractor->configure("method", options.beats.method,
+                                       "maxTempo", options.beats.maxTempo,
+                                       "minTempo", options.beats.minTempo);
 
             connect(neqloudSource, rhythmExtractor->input("signal"));
             connect(rhythmExtractor->output("ticks"),        neqloudPool, rhythmspace + "beats.position");
@@ -574,9 +690,7 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
             rhythmExtractor->output("confidence") >> NOWHERE;
 
             // Rhythm descriptor - bmp histogram
-            bool computeBpmHistogram = nspace.empty() ?
-                                       options.value<Real>("rhythm.bpmhistogram.compute") != 0 :
-                                       options.value<Real>("segmentation.desc.rhythm.bpmhistogram.compute") != 0;
+            bool computeBpmHistogram = passes.runs(StageBpmHistogram);
             if (computeBpmHistogram)
             {
 
@@ -594,9 +708,7 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
         }
 
         // Rhythm descriptor - onset
-        bool computeOnsets = nspace.empty() ?
-                             options.value<Real>("rhythm.onset.compute") != 0 :
-                             options.value<Real>("segmentation.desc.rhythm.onset.compute") != 0;
+        bool computeOnsets = passes.runs(StageOnset);
         if (computeOnsets)
         {
             // Onset Detection
@@ -607,16 +719,14 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
         }
 
         // Rhythm descriptor - danceability
-        bool computeDanceability = nspace.empty() ?
-                                   options.value<Real>("rhythm.danceability.compute") != 0 :
-                                   options.value<Real>("segmentation.desc.rhythm.danceability.compute") != 0;
+        bool computeDanceability = passes.runs(StageDanceability);
         if (computeDanceability)
         {
             Algorithm *danceability = factory.create("Danceability",
-                                      "minTau", options.value<Real>("rhythm.danceability.minTau"),
-                                      "maxTau", options.value<Real>("rhythm.danceability.maxTau"),
-                                      "tauMultiplier", options.value<Real>("rhythm.danceability.tauMultiplier"),
-                                      "sampleRate", options.value<Real>("analysisSampleRate"));
+                                      "minTau", options.danceability.minTau,
+                                      "maxTau", options.danceability.maxTau,
+                                      "tauMultiplier", options.danceability.tauMultiplier,
+                                      "sampleRate", options.analysisSampleRate);
             connect(neqloudSource, danceability->input("signal"));
             connect(danceability->output("danceability"), neqloudPool, rhythmspace + "danceability");
         }
@@ -625,15 +735,14 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
     if (eqloud)
     {
 
+        // Low-Level Spectral Descriptors
         if (doLowLevelSpectral)
-        {
-            // Low-Level Spectral Descriptors
-            LowLevelSpectral(eqloudSource, eqloudPool, options, nspace);
+            LowLevelSpectral(eqloudSource, frontEnd, eqloudPool, statsStore, &frameStore, options, nspace);
 
-            // Low-Level Spectral Equal Loudness Descriptors
-            // expects the audio source to already be equal-loudness filtered
-            LowLevelSpectralEqLoud(eqloudSource, eqloudPool, options, nspace);
-        }
+        // Low-Level Spectral Equal Loudness Descriptors
+        // expects the audio source to already be equal-loudness filtered
+        if (doLowLevelSpectralEqLoud)
+            LowLevelSpectralEqLoud(eqloudSource, frontEnd, eqloudPool, statsStore, &frameStore, options, nspace);
 
         // Level Descriptor
         // expects the audio source to already be equal-loudness filtered
@@ -643,16 +752,16 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
 
         // Tuning Frequency
         if (computeTonal)
-            TuningFrequency(eqloudSource, eqloudPool, options, nspace);
+            TuningFrequency(eqloudSource, frontEnd, peaksStore, eqloudPool, options, nspace);
 
         // Rhythm descriptor - beats
         if (computeBeats)
         {
 
             Algorithm *rhythmExtractor = factory.create("RhythmExtractor2013");
-            rhythmExtractor->configure("method", options.value<string>("rhythm.beats.method"),
-                                       "maxTempo", options.value<Real>("rhythm.beats.maxTempo"),
-                                       "minTempo", options.value<Real>("rhythm.beats.minTempo"));
+            rhythmExtractor->configure("method", options.beats.method,
+                                       "maxTempo", options.beats.maxTempo,
+                                       "minTempo", options.beats.minTempo);
 
             connect(eqloudSource, rhythmExtractor->input("signal"));
             connect(rhythmExtractor->output("ticks"),        eqloudPool, rhythmspace + "beats.position");
@@ -663,9 +772,7 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
             rhythmExtractor->output("confidence") >> NOWHERE;
 
             // Rhythm descriptor - bmp histogram
-            bool computeBpmHistogram = nspace.empty() ?
-                                       options.value<Real>("rhythm.bpmhistogram.compute") != 0 :
-                                       options.value<Real>("segmentation.desc.rhythm.bpmhistogram.compute") != 0;
+            bool computeBpmHistogram = passes.runs(StageBpmHistogram);
             if (computeBpmHistogram)
             {
                 // BPM Histogram descriptors
@@ -682,9 +789,7 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
         }
 
         // Rhythm descriptor - onset
-        bool computeOnsets = nspace.empty() ?
-                             options.value<Real>("rhythm.onset.compute") != 0 :
-                             options.value<Real>("segmentation.desc.rhythm.onset.compute") != 0;
+        bool computeOnsets = passes.runs(StageOnset);
         if (computeOnsets)
         {
             // Onset Detection
@@ -695,27 +800,85 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
         }
 
         // Rhythm descriptor - danceability
-        bool computeDanceability = nspace.empty() ?
-                                   options.value<Real>("rhythm.danceability.compute") != 0 :
-                                   options.value<Real>("segmentation.desc.rhythm.danceability.compute") != 0;
+        bool computeDanceability = passes.runs(StageDanceability);
         if (computeDanceability)
         {
             Algorithm *danceability = factory.create("Danceability",
-                                      "minTau", options.value<Real>("rhythm.danceability.minTau"),
-                                      "maxTau", options.value<Real>("rhythm.danceability.maxTau"),
-                                      "tauMultiplier", options.value<Real>("rhythm.danceability.tauMultiplier"),
-                                      "sampleRate", options.value<Real>("analysisSampleRate"));
+                                      "minTau", options.danceability.minTau,
+                                      "maxTau", options.danceability.maxTau,
+                                      "tauMultiplier", options.danceability.tauMultiplier,
+                                      "sampleRate", options.analysisSampleRate);
             connect(eqloudSource, danceability->input("signal"));
             connect(danceability->output("danceability"), eqloudPool, rhythmspace + "danceability");
         }
     }
 
-    Network network(streamEasyLoader);
-    network.run();
+    return streamEasyLoader;
+}
+
+void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
+                     const AnalysisOptions &options, TonalPeaks &tonalPeaks, DescriptorStatistics &frameStats,
+                     FrameStore &frameStore, Real startTime, Real endTime, const string &nspace, AnalysisPlan *plan)
+{
+    /*************************************************************************
+     *    2nd pass: normalize the audio with replay gain, compute as         *
+     *              many lowlevel descriptors as possible                    *
+     *************************************************************************/
+
+    cout << "Process step 2: Low Level" << endl;
+
+    // namespace:
+    string rhythmspace = "rhythm.";
+    if (!nspace.empty())
+    {
+        rhythmspace = nspace + ".rhythm.";
+    }
+
+    Real analysisSampleRate = options.analysisSampleRate;
+    Real replayGain = 0;
+    string downmix = "mix";
+
+    bool neqloud = options.nequalLoudness;
+    bool eqloud  = options.equalLoudness;
+
+    if (eqloud)
+    {
+        replayGain = eqloudPool.value<Real>("metadata.audio_properties.replay_gain");
+        downmix = eqloudPool.value<string>("metadata.audio_properties.downmix");
+    }
+    if (neqloud)
+    {
+        replayGain = neqloudPool.value<Real>("metadata.audio_properties.replay_gain");
+        downmix = neqloudPool.value<string>("metadata.audio_properties.downmix");
+    }
+
+    // segments write to their own descriptor names, only the whole file
+    // network can be kept by the plan
+    unique_ptr<Network> localNetwork;
+    Network *network = preparePass(plan && nspace.empty() ? plan->lowLevel : localNetwork, [&]()
+    {
+        return buildLowLevel(cb, neqloudPool, eqloudPool, options, tonalPeaks, frameStats, frameStore, nspace);
+    });
+
+    Algorithm *streamEasyLoader = network->visibleNetworkRoot()->algorithm();
+    streamEasyLoader->configure("sampleRate", analysisSampleRate,
+                                "startTime",  startTime,
+                                "endTime",    endTime,
+                                "replayGain", replayGain,
+                                "downmix",    downmix);
+
+    if (options.passes(nspace).runs(StagePanning))
+    {
+        network->findAlgorithm("stereo_trimmer")->configure("sampleRate", analysisSampleRate,
+                                                            "startTime",  startTime,
+                                                            "endTime",    endTime);
+    }
+
+    tonalPeaks.clear();
+
+    network->run();
 
-    bool computeOnsets = nspace.empty() ?
-                         options.value<Real>("rhythm.onset.compute") != 0 :
-                         options.value<Real>("segmentation.desc.rhythm.onset.compute") != 0;
+    bool computeOnsets = options.passes(nspace).runs(StageOnset);
     if (computeOnsets)
     {
         // compute onset rate = len(onsets) / len(audio)
@@ -734,65 +897,90 @@ void computeLowLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
     }
 
 
+    if (options.passes(nspace).runs(StageFades))
+    {
+        computeFades(neqloudPool, eqloudPool, options, nspace);
+    }
+
     // delete network only now, because we needed streamEasyLoader->output("audio") to
     // compute the onset rate on the previous line.
     //deleteNetwork(streamEasyLoader);
 }
 
-void computeMidLevel(const callbacks *cb, Pool &neqloudPool,
-                     Pool &eqloudPool, const Pool &options,
-                     Real startTime, Real endTime, const string &nspace)
+Algorithm *buildTonal(Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options,
+                      const TonalPeaks &tonalPeaks, DescriptorStatistics &frameStats, DescriptorMeans &tuningMeans,
+                      const string &nspace)
 {
+    Algorithm *peaksReader = new StreamTonalPeaksReader(&tonalPeaks);
+    peaksReader->declareParameters();
 
-    /*************************************************************************
-     *    4th pass: HPCP & beats loudness (depend on some descriptors that   *
-     *              have been computed during the 2nd pass)                  *
-     *************************************************************************/
+    // the HPCP are only stored frame by frame if one of their statistics
+    // needs all the frames
+    DescriptorStatistics *statsStore = FrameStatistics::supports(options.stats.tonal) ? &frameStats : nullptr;
 
-    cout << "Process step 4: Mid Level" << endl;
+    // Compute Tonal descriptors (needed TuningFrequency before)
+    TonalDescriptors(peaksReader->output("frequencies"), peaksReader->output("magnitudes"),
+                     options.equalLoudness ? eqloudPool : neqloudPool, statsStore, tuningMeans, options, nspace);
 
-    Real analysisSampleRate = options.value<Real>("analysisSampleRate");
-    Real replayGain = 0;
-    string downmix = "mix";
+    return peaksReader;
+}
+
+// Rebinds the tuning frequency of the current file to a reused tonal network.
+void bindTonal(Network *network, Pool &pool)
+{
+    Real tuningFreq = pool.value<vector<Real> >("tonal.tuning_frequency").back();
+    network->findAlgorithm("tonal_hpcp")->configure("referenceFrequency", tuningFreq);
+}
 
-    bool neqloud = options.value<Real>("nequalLoudness") != 0;
-    bool eqloud  = options.value<Real>("equalLoudness")  != 0;
+void computeTonal(Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options,
+                  const TonalPeaks &tonalPeaks, DescriptorStatistics &frameStats, DescriptorMeans &tuningMeans,
+                  const string &nspace, AnalysisPlan *plan)
+{
 
-    if (eqloud)
+    /*************************************************************************
+     *    3rd pass: HPCP, key & chords (depend on the tuning frequency), on  *
+     *              the spectral peaks recorded during the 2nd pass          *
+     *************************************************************************/
+
+    cout << "Process step 3: Tonal" << endl;
+
+    // segments write to their own descriptor names, only the whole file
+    // network can be kept by the plan
+    unique_ptr<Network> localNetwork;
+    unique_ptr<Network> &cached = plan && nspace.empty() ? plan->tonal : localNetwork;
+    bool reused = cached != nullptr;
+    Network *network = preparePass(cached, [&]()
     {
-        replayGain = eqloudPool.value<Real>("metadata.audio_properties.replay_gain");
-        downmix = eqloudPool.value<string>("metadata.audio_properties.downmix");
-    }
-    if (neqloud)
+        return buildTonal(neqloudPool, eqloudPool, options, tonalPeaks, frameStats, tuningMeans, nspace);
+    });
+
+    if (reused)
     {
-        replayGain = neqloudPool.value<Real>("metadata.audio_properties.replay_gain");
-        downmix = neqloudPool.value<string>("metadata.audio_properties.downmix");
+        bindTonal(network, options.equalLoudness ? eqloudPool : neqloudPool);
     }
 
+    network->run();
+}
+
+Algorithm *buildMidLevel(const callbacks *cb, Pool &neqloudPool, Pool &eqloudPool,
+                        const AnalysisOptions &options, const string &nspace)
+{
+    Real analysisSampleRate = options.analysisSampleRate;
+
+    bool neqloud = options.nequalLoudness;
+    bool eqloud  = options.equalLoudness;
+
     streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
 
     Algorithm *streamEasyLoader = new StreamEasyLoader(cb);
     streamEasyLoader->declareParameters();
-    streamEasyLoader->configure("sampleRate", analysisSampleRate,
-                                "startTime",  startTime,
-                                "endTime",    endTime,
-                                "replayGain", replayGain,
-                                "downmix",    downmix);
 
     if (neqloud)
     {
         SourceBase &neqloudSource = streamEasyLoader->output("audio");
-        // Compute Tonal descriptors (needed TuningFrequency before)
-        bool computeTonal = nspace.empty() ?
-                            options.value<Real>("tonal.compute") != 0 :
-                            options.value<Real>("segmentation.desc.tonal.compute") != 0;
-        if (computeTonal)
-            TonalDescriptors(neqloudSource, neqloudPool, options, nspace);
 
         // Compute the loudness at the beats position (needed beats position)
-        bool computeBeats = nspace.empty() ?
-                            options.value<Real>("rhythm.beats.loudness.compute") != 0 :
-                            options.value<Real>("segmentation.desc.rhythm.beats.loudness.compute") != 0;
+        bool computeBeats = options.passes(nspace).runs(StageBeatsLoudness);
         if (computeBeats)
         {
             string rhythmspace = "rhythm.";
@@ -802,6 +990,8 @@ void computeMidLevel(const callbacks *cb, Pool &neqloudPool,
             Algorithm *beatsLoudness = factory.create("BeatsLoudness",
                                        "sampleRate", analysisSampleRate,
                                        "beats", ticks);
+            // the beats are rebound for every file, see bindMidLevel()
+            beatsLoudness->setName("beats_loudness");
 
             connect(neqloudSource, beatsLoudness->input("signal"));
             connect(beatsLoudness->output("loudness"), neqloudPool, rhythmspace + "beats.loudness");
@@ -814,17 +1004,9 @@ void computeMidLevel(const callbacks *cb, Pool &neqloudPool,
         Algorithm *eqloud3 = factory.create("EqualLoudness");
         connect(streamEasyLoader->output("audio"), eqloud3->input("signal"));
         SourceBase &eqloudSource = eqloud3->output("signal");
-        // Compute Tonal descriptors (needed TuningFrequency before)
-        bool computeTonal = nspace.empty() ?
-                            options.value<Real>("tonal.compute") != 0 :
-                            options.value<Real>("segmentation.desc.tonal.compute") != 0;
-        if (computeTonal)
-            TonalDescriptors(eqloudSource, eqloudPool, options, nspace);
 
         // Compute the loudness at the beats position (needed beats position)
-        bool computeBeats = nspace.empty() ?
-                            options.value<Real>("rhythm.beats.loudness.compute") != 0 :
-                            options.value<Real>("segmentation.desc.rhythm.beats.loudness.compute") != 0;
+        bool computeBeats = options.passes(nspace).runs(StageBeatsLoudness);
         if (computeBeats)
         {
             string rhythmspace = "rhythm.";
@@ -834,6 +1016,8 @@ void computeMidLevel(const callbacks *cb, Pool &neqloudPool,
             Algorithm *beatsLoudness = factory.create("BeatsLoudness",
                                        "sampleRate", analysisSampleRate,
                                        "beats", ticks);
+            // the beats are rebound for every file, see bindMidLevel()
+            beatsLoudness->setName("beats_loudness");
 
             connect(eqloudSource, beatsLoudness->input("signal"));
             connect(beatsLoudness->output("loudness"), eqloudPool, rhythmspace + "beats.loudness");
@@ -841,54 +1025,104 @@ void computeMidLevel(const callbacks *cb, Pool &neqloudPool,
         }
     }
 
-    Network network(streamEasyLoader);
-    network.run();
+    return streamEasyLoader;
 }
 
-void computePanning(const callbacks *cb, Pool &neqloudPool,
-                    Pool &eqloudPool, const Pool &options,
-                    Real startTime, Real endTime, const string &nspace)
+// Rebinds the parameters of a reused mid level network which depend on the
+// results of the previous passes of the current file.
+void bindMidLevel(Network *network, Pool &pool, const AnalysisOptions &options)
+{
+    if (options.trackPasses.runs(StageBeatsLoudness))
+    {
+        vector<Real> ticks = pool.value<vector<Real> >("rhythm.beats.position");
+        network->findAlgorithm("beats_loudness")->configure("beats", ticks);
+    }
+}
+
+void computeMidLevel(const callbacks *cb, Pool &neqloudPool,
+                     Pool &eqloudPool, const AnalysisOptions &options,
+                     Real startTime, Real endTime, const string &nspace, AnalysisPlan *plan)
 {
 
     /*************************************************************************
-     *    5th pass: Panning                                                  *
-     *                                                                       *
+     *    4th pass: beats loudness (depends on the beats that have been      *
+     *              computed during the 2nd pass)                            *
      *************************************************************************/
 
-    cout << "Process step 5: Panning" << endl;
+    cout << "Process step 4: Mid Level" << endl;
+
+    Real analysisSampleRate = options.analysisSampleRate;
+    Real replayGain = 0;
+    string downmix = "mix";
+
+    bool neqloud = options.nequalLoudness;
+    bool eqloud  = options.equalLoudness;
+
+    if (eqloud)
+    {
+        replayGain = eqloudPool.value<Real>("metadata.audio_properties.replay_gain");
+        downmix = eqloudPool.value<string>("metadata.audio_properties.downmix");
+    }
+    if (neqloud)
+    {
+        replayGain = neqloudPool.value<Real>("metadata.audio_properties.replay_gain");
+        downmix = neqloudPool.value<string>("metadata.audio_properties.downmix");
+    }
+
+    // segments write to their own descriptor names, only the whole file
+    // network can be kept by the plan
+    unique_ptr<Network> localNetwork;
+    unique_ptr<Network> &cached = plan && nspace.empty() ? plan->midLevel : localNetwork;
+    bool reused = cached != nullptr;
+    Network *network = preparePass(cached, [&]()
+    {
+        return buildMidLevel(cb, neqloudPool, eqloudPool, options, nspace);
+    });
+
+    if (reused)
+    {
+        bindMidLevel(network, eqloud ? eqloudPool : neqloudPool, options);
+    }
 
-    Real analysisSampleRate = options.value<Real>("analysisSampleRate");
-    bool neqloud = options.value<Real>("nequalLoudness") != 0;
-    bool eqloud =  options.value<Real>("equalLoudness")  != 0;
+    Algorithm *streamEasyLoader = network->visibleNetworkRoot()->algorithm();
+    streamEasyLoader->configure("sampleRate", analysisSampleRate,
+                                "startTime",  startTime,
+                                "endTime",    endTime,
+                                "replayGain", replayGain,
+                                "downmix",    downmix);
 
-    Algorithm *streamAudioLoader = new StreamAudioLoader(cb);
-    streamAudioLoader->declareParameters();
-    streamAudioLoader->configure("sampleRate", analysisSampleRate);
+    network->run();
+}
 
+// Panning, on the stereo signal of the loader of the low level pass
+void buildPanning(SourceBase &stereo, Pool &neqloudPool, Pool &eqloudPool,
+                  const AnalysisOptions &options, const string &nspace)
+{
+    bool neqloud = options.nequalLoudness;
+    bool eqloud =  options.equalLoudness;
 
+    // trimmed for every file, see computeLowLevel()
     Algorithm *stereoTrimmer = new StreamStereoTrimmer();
     stereoTrimmer->declareParameters();
-    stereoTrimmer->configure("startTime", startTime,
-                             "endTime", endTime);
+    stereoTrimmer->setName("stereo_trimmer");
 
-    connect(streamAudioLoader->output("audio"), stereoTrimmer->input("signal"));
-    connect(streamAudioLoader->output("numberChannels"), NOWHERE);
+    connect(stereo, stereoTrimmer->input("signal"));
 
     // namespace
     string panningspace = "panning.";
     if (!nspace.empty()) panningspace = nspace + ".panning.";
 
-    Real sampleRate = options.value<Real>("analysisSampleRate");
-    int frameSize   = int(options.value<Real>("panning.frameSize"));
-    int hopSize     = int(options.value<Real>("panning.hopSize"));
-    int averageFrames = int(options.value<Real>("panning.averageFrames"));
-    int panningBins   = int(options.value<Real>("panning.panningBins"));
-    int numCoeffs     = int(options.value<Real>("panning.numCoeffs"));
-    int numBands      = int(options.value<Real>("panning.numBands"));
-    bool warpedPanorama = options.value<Real>("panning.warpedPanorama");
-    int zeroPadding     = int(options.value<Real>("panning.zeroPadding"));
-    string silentFrames = options.value<string>("panning.silentFrames");
-    string windowType   = options.value<string>("panning.windowType");
+    Real sampleRate = options.analysisSampleRate;
+    int frameSize   = options.panning.frame.frameSize;
+    int hopSize     = options.panning.frame.hopSize;
+    int averageFrames = options.panning.averageFrames;
+    int panningBins   = options.panning.panningBins;
+    int numCoeffs     = options.panning.numCoeffs;
+    int numBands      = options.panning.numBands;
+    bool warpedPanorama = options.panning.warpedPanorama;
+    int zeroPadding     = options.panning.frame.zeroPadding;
+    string silentFrames = options.panning.frame.silentFrames;
+    string windowType   = options.panning.frame.windowType;
 
     streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
 
@@ -916,9 +1150,9 @@ void computePanning(const callbacks *cb, Pool &neqloudPool,
                                         "zeroPadding", zeroPadding,
                                         "type", windowType);
 
-    Algorithm *spec_left = factory.create("Spectrum");
-
-    Algorithm *spec_right = factory.create("Spectrum");
+    // both channels are transformed with one complex FFT
+    Algorithm *spec = factory.create("StereoSpectrum",
+                                     "size", frameSize + zeroPadding);
 
     Algorithm *pan = factory.create("Panning",
                                     "sampleRate", sampleRate,
@@ -933,19 +1167,17 @@ void computePanning(const callbacks *cb, Pool &neqloudPool,
     connect(demuxer->output("right"), fc_right->input("signal"));
     // left channel
     connect(fc_left->output("frame"), w_left->input("frame"));
-    connect(w_left->output("frame"), spec_left->input("frame"));
-    connect(spec_left->output("spectrum"), pan->input("spectrumLeft"));
+    connect(w_left->output("frame"), spec->input("left"));
     // right channel
     connect(fc_right->output("frame"), w_right->input("frame"));
-    connect(w_right->output("frame"), spec_right->input("frame"));
-    connect(spec_right->output("spectrum"), pan->input("spectrumRight"));
+    connect(w_right->output("frame"), spec->input("right"));
+
+    connect(spec->output("spectrumLeft"), pan->input("spectrumLeft"));
+    connect(spec->output("spectrumRight"), pan->input("spectrumRight"));
 
     // no difference between eqloud and neqloud, both are taken as non eqloud
     if (neqloud) connect(pan->output("panningCoeffs"), neqloudPool, panningspace + "panning_coefficients");
     if (eqloud) connect(pan->output("panningCoeffs"), eqloudPool, panningspace + "panning_coefficients");
-
-    Network network(streamAudioLoader);
-    network.run();
 }
 
 typedef TNT::Array2D<Real> array2d;
@@ -962,63 +1194,38 @@ void addToPool(const array2d &a2d,
     }
 }
 
-void computeFades(const callbacks *cb, Pool &neqloudPool,
-                  Pool &eqloudPool, const Pool &options,
-                  Real startTime, Real endTime, const string &nspace)
+void computeFades(Pool &neqloudPool, Pool &eqloudPool, const AnalysisOptions &options, const string &nspace)
 {
 
     /*************************************************************************
-     *    6th pass: Fades                                                    *
-     *                                                                       *
+     *    Fades: detected on the RMS of the frames computed during the 2nd   *
+     *           pass                                                        *
      *************************************************************************/
 
-    cout << "Process step 6: Fades" << endl;
-
-    Real analysisSampleRate = options.value<Real>("analysisSampleRate");
-    Real replayGain = 0;
-    string downmix = "mix";
+    cout << "Process step 2: Fades" << endl;
 
-    bool neqloud = options.value<Real>("nequalLoudness") != 0;
-    bool eqloud  = options.value<Real>("equalLoudness")  != 0;
-
-    if (eqloud)
-    {
-        replayGain = eqloudPool.value<Real>("metadata.audio_properties.replay_gain");
-        downmix = eqloudPool.value<string>("metadata.audio_properties.downmix");
-    }
-    if (neqloud)
-    {
-        replayGain = neqloudPool.value<Real>("metadata.audio_properties.replay_gain");
-        downmix = neqloudPool.value<string>("metadata.audio_properties.downmix");
-    }
+    bool neqloud = options.nequalLoudness;
+    bool eqloud  = options.equalLoudness;
 
     // namespace
     string fadesspace = "fades.";
     if (!nspace.empty()) fadesspace = nspace + ".fades.";
 
-    int frameSize   = int(options.value<Real>("fades.frameSize"));
-    int hopSize     = int(options.value<Real>("fades.hopSize"));
-    int frameRate   = int(options.value<Real>("fades.frameRate"));
-    int minLength   = int(options.value<Real>("fades.minLength"));
-    Real cutoffHigh = options.value<Real>("fades.cutoffHigh");
-    Real cutoffLow  = options.value<Real>("fades.cutoffLow");
-
-    standard::AlgorithmFactory &factory = standard::AlgorithmFactory::instance();
+    int frameRate   = int(options.fades.frameRate);
+    int minLength   = int(options.fades.minLength);
+    Real cutoffHigh = options.fades.cutoffHigh;
+    Real cutoffLow  = options.fades.cutoffLow;
 
-    standard::Algorithm *easyLoader = new EasyLoader(cb);
-    easyLoader->declareParameters();
-    easyLoader->configure("sampleRate", analysisSampleRate,
-                          "startTime",  startTime,
-                          "endTime",    endTime,
-                          "replayGain", replayGain,
-                          "downmix",    downmix);
-
-
-    shared_ptr<standard::Algorithm> frameCutter(factory.create("FrameCutter",
-            "frameSize", frameSize,
-            "hopSize", hopSize));
+    // the rms values are only needed here
+    Pool &pool = eqloud ? eqloudPool : neqloudPool;
+    vector<Real> rms_vector;
+    if (pool.contains<vector<Real> >(fadesspace + "rms"))
+    {
+        rms_vector = pool.value<vector<Real> >(fadesspace + "rms");
+        pool.remove(fadesspace + "rms");
+    }
 
-    shared_ptr<standard::Algorithm> rms(factory.create("RMS"));
+    standard::AlgorithmFactory &factory = standard::AlgorithmFactory::instance();
 
     shared_ptr<standard::Algorithm> fadeDetect(factory.create("FadeDetection",
             "minLength", minLength,
@@ -1026,38 +1233,6 @@ void computeFades(const callbacks *cb, Pool &neqloudPool,
             "cutoffLow", cutoffLow,
             "frameRate", frameRate));
 
-    vector<Real> audio_easy;
-    easyLoader->output("audio").set(audio_easy);
-
-    // set frameCutter:
-    vector<Real> frame;
-    frameCutter->input("signal").set(audio_easy);
-    frameCutter->output("frame").set(frame);
-
-    // set rms:
-    Real rms_value;
-    rms->input("array").set(frame);
-    rms->output("rms").set(rms_value);
-
-    // we need a vector to store rms values:
-    std::vector<Real> rms_vector;
-
-    cout << "-------- start processing --------" << endl;
-
-    // load audio:
-    easyLoader->compute();
-
-    // compute and store rms first and will compute fade detection later:
-    while (true)
-    {
-        frameCutter->compute();
-        if (frame.empty())
-            break;
-
-        rms->compute();
-        rms_vector.push_back(rms_value);
-    }
-
     // set fade detection:
     array2d fade_in;
     array2d fade_out;
@@ -1080,7 +1255,7 @@ void computeFades(const callbacks *cb, Pool &neqloudPool,
     }
 }
 
-void computeHighlevel(Pool &pool, const Pool &options, const string &nspace)
+void computeHighlevel(Pool &pool, const DescriptorMeans &tuningMeans, const AnalysisOptions &options, const string &nspace)
 {
 
     /*************************************************************************
@@ -1090,10 +1265,10 @@ void computeHighlevel(Pool &pool, const Pool &options, const string &nspace)
 
     cout << "Process step 7: High Level" << endl;
 
+    const PassSchedule &passes = options.passes(nspace);
+
     // Average Level
-    bool computeAverageLoudness = nspace.empty() ?
-                                  options.value<Real>("average_loudness.compute") != 0 :
-                                  options.value<Real>("segmentation.desc.average_loudness.compute") != 0;
+    bool computeAverageLoudness = passes.runs(StageLevel);
 
     // did we manage to get an estimation for the loudness during low level compute (2 seconds required)
     try
@@ -1110,19 +1285,15 @@ void computeHighlevel(Pool &pool, const Pool &options, const string &nspace)
         LevelAverage(pool, nspace);
 
     // SFX Descriptors
-    bool computeSfx = nspace.empty() ?
-                      options.value<Real>("sfx.compute") != 0 :
-                      options.value<Real>("segmentation.desc.sfx.compute") != 0;
+    bool computeSfx = passes.runs(StageSfx);
     if (computeSfx)
         SFXPitch(pool, nspace);
 
     // Tuning System Features
-    bool computeTonal = nspace.empty() ?
-                        options.value<Real>("tonal.compute") != 0 :
-                        options.value<Real>("segmentation.desc.tonal.compute") != 0;
+    bool computeTonal = passes.runs(StageTonalDescriptors);
     if (computeTonal)
     {
-        TuningSystemFeatures(pool, nspace);
+        TuningSystemFeatures(pool, tuningMeans, nspace);
         // Pool Cleaning (remove temporary descriptors)
         TonalPoolCleaning(pool, nspace);
     }
@@ -24,6 +24,8 @@
 #define ALL_DETECTION_ALGORITHMS_H
 
 #include "IEssentiaAlgorithm.h"
+#include "AnalysisPlan.h"
+#include "HostAllocator.h"
 
 namespace essentiawrapper {
 
@@ -33,9 +35,29 @@ public:
     AllDetectionAlgorithms();
     virtual ~AllDetectionAlgorithms();
 
+    /**
+     * @brief Builds the analysis plan for the given configuration. The plan is
+     * reused by every following call of analyze(callbacks *).
+     */
+    void compile(const essentia::Pool &config);
+
+    /**
+     * @brief Analyzes one file with the compiled plan.
+     */
+    void analyze(callbacks *cb);
+
     // IEssentiaAlgorithm interface
     virtual void analyze(callbacks *cb, const essentia::Pool &config) override;
     virtual std::vector<float> get(const std::string &configName, bool eqLoudPool) override;
+    virtual size_t copy(const std::string &configName, bool eqLoudPool, float *buffer, size_t capacity) override;
+
+    /**
+     * @brief The aggregated pool of the last analysis, as written to the
+     * output file, or nullptr if nothing was analyzed. It is aggregated on the
+     * first request when no output file was written. Every analysis creates
+     * new pools, so the returned pool stays valid while it is held.
+     */
+    std::shared_ptr<const essentia::Pool> results(bool eqLoudPool);
 
 private:
 
@@ -43,6 +65,17 @@ private:
     essentia::Pool _neqloudPool; // non equal loudness pool
     essentia::Pool _eqloudPool; // equal loudness pool
 
+    // aggregated results of the pools above
+    std::shared_ptr<essentia::Pool> _neqloudResults;
+    std::shared_ptr<essentia::Pool> _eqloudResults;
+    bool _analyzed;
+
+    // the transient memory of the last analysis, read by results()
+    AnalysisArena _arena;
+
+    // writes into the pools above, so it is released before them
+    std::unique_ptr<AnalysisPlan> _plan;
+
 };
 
 } // namespace essentiawrapper
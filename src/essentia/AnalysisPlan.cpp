@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "AnalysisPlan.h"
+
+#include <cstring>
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+AnalysisPlan::AnalysisPlan(const Pool &config)
+{
+    memset(&_callbacks, 0, sizeof(_callbacks));
+
+    parseOptions(_options, config);
+}
+
+AnalysisPlan::~AnalysisPlan()
+{
+    unbind();
+    clear();
+}
+
+const callbacks *AnalysisPlan::bind(const callbacks *cb)
+{
+    if (cb)
+    {
+        _callbacks = *cb;
+    }
+
+    return &_callbacks;
+}
+
+void AnalysisPlan::unbind()
+{
+    if (_callbacks.close_audio)
+    {
+        _callbacks.close_audio(_callbacks.audio_file);
+    }
+
+    memset(&_callbacks, 0, sizeof(_callbacks));
+}
+
+void AnalysisPlan::clearFrames()
+{
+    tonalPeaks.clear();
+    frameStore.clear();
+}
+
+void AnalysisPlan::clear()
+{
+    // the networks own their algorithms, including the loaders
+    replayGain.reset();
+    lowLevel.reset();
+    tonal.reset();
+    midLevel.reset();
+}
+
+} // namespace essentiawrapper
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef ANALYSIS_PLAN_H
+#define ANALYSIS_PLAN_H
+
+#include <memory>
+
+#include "essentia_wrapper.h"
+#include "configuration/analysis_options.h"
+#include "standard/StreamTonalPeaks.h"
+#include "standard/FrameStatistics.h"
+#include "standard/FrameStore.h"
+#include "pool.h"
+#include "scheduler/network.h"
+
+namespace essentiawrapper {
+
+/**
+ * @brief The AnalysisPlan class holds everything that only depends on the
+ * configuration: the parsed options and the streaming networks of the whole
+ * file passes.
+ *
+ * The networks are built on first use and kept alive, so analysing another
+ * file only resets them and binds the new loader callbacks and per-file
+ * parameters (replay gain, downmix, trimming). The result pools the networks
+ * write to must outlive the plan.
+ */
+class AnalysisPlan
+{
+public:
+    explicit AnalysisPlan(const essentia::Pool &config);
+    ~AnalysisPlan();
+
+    const AnalysisOptions &options() const { return _options; }
+
+    /**
+     * @brief Binds the client callbacks for the next file.
+     * @return The callbacks the cached loaders read from.
+     */
+    const callbacks *bind(const callbacks *cb);
+
+    /**
+     * @brief Closes the audio file of the current analysis and detaches the
+     * callbacks, so cached loaders never touch a stale file handle.
+     */
+    void unbind();
+
+    /**
+     * @brief Drops the peaks and frames of the last file, they are in the
+     * arena of its analysis which is rewound for the next one.
+     */
+    void clearFrames();
+
+    // cached networks of the whole file passes, built on first use
+    std::unique_ptr<essentia::scheduler::Network> replayGain;
+    std::unique_ptr<essentia::scheduler::Network> lowLevel;
+    std::unique_ptr<essentia::scheduler::Network> tonal;
+    std::unique_ptr<essentia::scheduler::Network> midLevel;
+
+    // written by the low level network, read by the tonal network
+    TonalPeaks tonalPeaks;
+
+    // the statistics of the frame descriptors, the sinks of the low level
+    // network point to its entries
+    DescriptorStatistics frameStats;
+    FrameStore frameStore;
+
+    // the means of the HPCP for the tuning system features, the sinks of the
+    // tonal network point to its entries
+    DescriptorMeans tuningMeans;
+
+private:
+    AnalysisPlan(const AnalysisPlan &) = delete;
+    AnalysisPlan &operator=(const AnalysisPlan &) = delete;
+
+    void clear();
+
+    AnalysisOptions _options;
+
+    // the loaders keep a pointer to these callbacks
+    callbacks _callbacks;
+};
+
+} // namespace essentiawrapper
+
+#endif // ANALYSIS_PLAN_H
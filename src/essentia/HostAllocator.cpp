@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "HostAllocator.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <mutex>
+
+namespace essentiawrapper {
+
+namespace {
+
+void *defaultAllocate(size_t size, void *)
+{
+    return malloc(size);
+}
+
+void defaultRelease(void *pointer, void *)
+{
+    free(pointer);
+}
+
+const HostAllocatorHooks defaultHooks = { defaultAllocate, defaultRelease, nullptr };
+
+mutex hooksMutex;
+HostAllocatorHooks currentHooks = defaultHooks;
+
+thread_local AnalysisArena *threadArena = nullptr;
+
+// the hooks in front of a block, padded so the block stays aligned for any type
+union BlockHeader
+{
+    HostAllocatorHooks hooks;
+    max_align_t alignment;
+};
+
+} // namespace
+
+void setHostAllocator(const HostAllocatorHooks &hooks)
+{
+    lock_guard<mutex> lock(hooksMutex);
+
+    if (!hooks.allocate && !hooks.release) currentHooks = defaultHooks;
+    else currentHooks = hooks;
+}
+
+HostAllocatorHooks hostAllocator()
+{
+    lock_guard<mutex> lock(hooksMutex);
+    return currentHooks;
+}
+
+void *allocateHostBlock(size_t size)
+{
+    HostAllocatorHooks hooks = hostAllocator();
+
+    BlockHeader *header = static_cast<BlockHeader *>(hooks.allocate(sizeof(BlockHeader) + size, hooks.context));
+    if (!header) throw bad_alloc();
+
+    header->hooks = hooks;
+    return header + 1;
+}
+
+void releaseHostBlock(void *block)
+{
+    if (!block) return;
+
+    BlockHeader *header = static_cast<BlockHeader *>(block) - 1;
+    HostAllocatorHooks hooks = header->hooks;
+    hooks.release(header, hooks.context);
+}
+
+const size_t AnalysisArena::blockSize;
+
+AnalysisArena::~AnalysisArena()
+{
+    for (const Block &block : _blocks) releaseHostBlock(block.data);
+}
+
+void *AnalysisArena::allocate(size_t size, size_t alignment)
+{
+    // the blocks kept from the previous analyses first
+    for (; _current < _blocks.size(); ++_current, _offset = 0)
+    {
+        const Block &block = _blocks[_current];
+        size_t offset = (_offset + alignment - 1) & ~(alignment - 1);
+        if (offset <= block.size && block.size - offset >= size)
+        {
+            _offset = offset + size;
+            return block.data + offset;
+        }
+    }
+
+    // the host blocks are aligned for any type
+    Block block = { nullptr, max(blockSize, size) };
+    block.data = static_cast<char *>(allocateHostBlock(block.size));
+    _blocks.push_back(block);
+
+    _offset = size;
+    return block.data;
+}
+
+ArenaScope::ArenaScope(AnalysisArena &arena) : _previous(threadArena)
+{
+    threadArena = &arena;
+}
+
+ArenaScope::~ArenaScope()
+{
+    threadArena = _previous;
+}
+
+AnalysisArena *currentArena()
+{
+    return threadArena;
+}
+
+} // namespace essentiawrapper
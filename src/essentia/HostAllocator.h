@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef HOST_ALLOCATOR_H
+#define HOST_ALLOCATOR_H
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+namespace essentiawrapper {
+
+typedef void *(*HostMallocFunction)(size_t size, void *context);
+typedef void (*HostFreeFunction)(void *pointer, void *context);
+
+/**
+ * @brief The allocation functions of the host, with the context passed to
+ * them.
+ */
+struct HostAllocatorHooks
+{
+    HostMallocFunction allocate;
+    HostFreeFunction release;
+    void *context;
+
+    bool operator==(const HostAllocatorHooks &other) const
+    {
+        return allocate == other.allocate && release == other.release && context == other.context;
+    }
+    bool operator!=(const HostAllocatorHooks &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Sets the hooks of the next allocations, malloc and free if both
+ * functions are nullptr. The memory is always released with the hooks it was
+ * allocated with, so the hooks can be changed between analyses.
+ */
+void setHostAllocator(const HostAllocatorHooks &hooks);
+
+HostAllocatorHooks hostAllocator();
+
+/**
+ * @brief Allocates a block that remembers its hooks, for the arrays handed
+ * to the host. Throws std::bad_alloc if the host returns nullptr.
+ */
+void *allocateHostBlock(size_t size);
+
+// frees a block of allocateHostBlock, nullptr is ignored
+void releaseHostBlock(void *block);
+
+/**
+ * @brief Monotonic arena of the transient memory of one analysis.
+ *
+ * Allocating only moves an offset in blocks taken from the host allocator,
+ * freeing does nothing, and the whole arena is rewound for the next
+ * analysis. The blocks are kept, so analysing another file does not
+ * allocate again, and every analysis has its own arena, so analyses running
+ * in parallel do not contend on the heap.
+ */
+class AnalysisArena
+{
+public:
+    static const size_t blockSize = 1 << 20;
+
+    AnalysisArena() : _current(0), _offset(0) {}
+    ~AnalysisArena();
+
+    // aligned for any type
+    void *allocate(size_t size, size_t alignment);
+
+    // nothing allocated before may be used anymore
+    void reset() { _current = 0; _offset = 0; }
+
+private:
+    AnalysisArena(const AnalysisArena &) = delete;
+    AnalysisArena &operator=(const AnalysisArena &) = delete;
+
+    struct Block
+    {
+        char *data;
+        size_t size;
+    };
+
+    vector<Block> _blocks;
+    size_t _current;
+    size_t _offset;
+};
+
+/**
+ * @brief Makes @e arena the arena of the HostAllocator constructed on this
+ * thread until the scope ends.
+ */
+class ArenaScope
+{
+public:
+    explicit ArenaScope(AnalysisArena &arena);
+    ~ArenaScope();
+
+private:
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+    AnalysisArena *_previous;
+};
+
+// the arena of the innermost ArenaScope of this thread, nullptr outside
+AnalysisArena *currentArena();
+
+/**
+ * @brief Standard allocator for the buffers that grow with the length of the
+ * audio. Constructed in an ArenaScope it takes the memory from the arena,
+ * otherwise from the hooks set when it is constructed.
+ *
+ * The allocator moves with the memory, so assigning an empty container
+ * created in the scope of an analysis moves a kept container to its arena.
+ */
+template <typename T>
+class HostAllocator
+{
+public:
+    typedef T value_type;
+    typedef true_type propagate_on_container_copy_assignment;
+    typedef true_type propagate_on_container_move_assignment;
+    typedef true_type propagate_on_container_swap;
+
+    HostAllocator() : _hooks(hostAllocator()), _arena(currentArena()) {}
+
+    template <typename U>
+    HostAllocator(const HostAllocator<U> &other) : _hooks(other.hooks()), _arena(other.arena()) {}
+
+    T *allocate(size_t n)
+    {
+        if (_arena) return static_cast<T *>(_arena->allocate(n * sizeof(T), alignof(T)));
+
+        void *pointer = _hooks.allocate(n * sizeof(T), _hooks.context);
+        if (!pointer) throw bad_alloc();
+
+        return static_cast<T *>(pointer);
+    }
+
+    void deallocate(T *pointer, size_t)
+    {
+        // released with the arena
+        if (_arena) return;
+
+        _hooks.release(pointer, _hooks.context);
+    }
+
+    const HostAllocatorHooks &hooks() const { return _hooks; }
+    AnalysisArena *arena() const { return _arena; }
+
+private:
+    HostAllocatorHooks _hooks;
+    AnalysisArena *_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const HostAllocator<T> &a, const HostAllocator<U> &b)
+{
+    return a.arena() == b.arena() && (a.arena() || a.hooks() == b.hooks());
+}
+
+template <typename T, typename U>
+bool operator!=(const HostAllocator<T> &a, const HostAllocator<U> &b) { return !(a == b); }
+
+template <typename T>
+using HostVector = vector<T, HostAllocator<T> >;
+
+} // namespace essentiawrapper
+
+#endif // HOST_ALLOCATOR_H
@@ -14,6 +14,13 @@ public:
     virtual ~IEssentiaAlgorithm() = default;
     virtual void analyze(callbacks *cb, const essentia::Pool &config) = 0;
     virtual std::vector<float> get(const std::string &configName, bool eqLoudPool) = 0;
+
+    /**
+     * @brief Copies the values of a result to @e buffer, a nullptr buffer
+     * only queries the size.
+     * @return The number of values, at most @e capacity of them are copied.
+     */
+    virtual size_t copy(const std::string &configName, bool eqLoudPool, float *buffer, size_t capacity) = 0;
 };
 
 typedef std::shared_ptr<IEssentiaAlgorithm> IEssentiaAlgorithmPtr_t;
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "analysis_options.h"
+
+#include "config_util.h"
+
+#include <range.h>
+#include <memory>
+#include <sstream>
+
+namespace {
+
+const char *windowTypes = "{hamming,hann,triangular,square,blackmanharris62,blackmanharris70,blackmanharris74,blackmanharris92}";
+const char *silentFrameModes = "{drop,keep,noise}";
+
+// the ranges use the same syntax as the essentia parameter ranges
+void checkRange(const string &name, const Parameter &value, const string &range)
+{
+    unique_ptr<Range> r(Range::create(range));
+    if (!r->contains(value))
+    {
+        ostringstream msg;
+        msg << "Option " << name << " = " << value << " is out of range " << range;
+        throw EssentiaException(msg);
+    }
+}
+
+bool boolOption(const Pool &pool, const string &name)
+{
+    return pool.value<Real>(name) != 0;
+}
+
+Real realOption(const Pool &pool, const string &name, const string &range)
+{
+    Real value = pool.value<Real>(name);
+    checkRange(name, Parameter(value), range);
+    return value;
+}
+
+int intOption(const Pool &pool, const string &name, const string &range)
+{
+    return int(realOption(pool, name, range));
+}
+
+string stringOption(const Pool &pool, const string &name, const string &range = "")
+{
+    string value = pool.value<string>(name);
+    if (!range.empty())
+    {
+        checkRange(name, Parameter(value), range);
+    }
+    return value;
+}
+
+void parseDescriptors(DescriptorOptions &desc, const Pool &pool, const string &prefix)
+{
+    desc.lowlevel        = boolOption(pool, prefix + "lowlevel.compute");
+    desc.averageLoudness = boolOption(pool, prefix + "average_loudness.compute");
+    desc.beats           = boolOption(pool, prefix + "rhythm.beats.compute");
+    desc.beatsLoudness   = boolOption(pool, prefix + "rhythm.beats.loudness.compute");
+    desc.bpmHistogram    = boolOption(pool, prefix + "rhythm.bpmhistogram.compute");
+    desc.onset           = boolOption(pool, prefix + "rhythm.onset.compute");
+    desc.danceability    = boolOption(pool, prefix + "rhythm.danceability.compute");
+    desc.tonal           = boolOption(pool, prefix + "tonal.compute");
+    desc.sfx             = boolOption(pool, prefix + "sfx.compute");
+    desc.panning         = boolOption(pool, prefix + "panning.compute");
+    desc.fades           = boolOption(pool, prefix + "fades.compute");
+
+    // beat detection needed if beatsloudness or bpmhistogram detection is requested
+    if (desc.beatsLoudness || desc.bpmHistogram)
+    {
+        desc.beats = true;
+    }
+}
+
+void parseFrame(FrameOptions &frame, const Pool &pool, const string &prefix)
+{
+    frame.frameSize    = intOption(pool, prefix + ".frameSize", "[1,inf)");
+    frame.hopSize      = intOption(pool, prefix + ".hopSize", "[1,inf)");
+    frame.zeroPadding  = pool.contains<Real>(prefix + ".zeroPadding") ?
+                         intOption(pool, prefix + ".zeroPadding", "[0,inf)") : 0;
+    frame.windowType   = stringOption(pool, prefix + ".windowType", windowTypes);
+    frame.silentFrames = stringOption(pool, prefix + ".silentFrames", silentFrameModes);
+}
+
+void parseSpectral(SpectralDescriptors &desc, const Pool &pool)
+{
+    desc.silenceRate         = boolOption(pool, "lowlevel.silence_rate.compute");
+    desc.zeroCrossingRate    = boolOption(pool, "lowlevel.zerocrossingrate.compute");
+    desc.mfcc                = boolOption(pool, "lowlevel.mfcc.compute");
+    desc.spectralDecrease    = boolOption(pool, "lowlevel.spectral_decrease.compute");
+    desc.spectralEnergy      = boolOption(pool, "lowlevel.spectral_energy.compute");
+    desc.spectralEnergyBands = boolOption(pool, "lowlevel.spectral_energyband.compute");
+    desc.hfc                 = boolOption(pool, "lowlevel.hfc.compute");
+    desc.frequencyBands      = boolOption(pool, "lowlevel.frequency_bands.compute");
+    desc.spectralRms         = boolOption(pool, "lowlevel.spectral_rms.compute");
+    desc.spectralFlux        = boolOption(pool, "lowlevel.spectral_flux.compute");
+    desc.spectralRolloff     = boolOption(pool, "lowlevel.spectral_rolloff.compute");
+    desc.spectralStrongPeak  = boolOption(pool, "lowlevel.spectral_strongpeak.compute");
+    desc.barkBands           = boolOption(pool, "lowlevel.barkbands.compute");
+    desc.spectralCrest       = boolOption(pool, "lowlevel.spectral_crest.compute");
+    desc.spectralFlatnessDb  = boolOption(pool, "lowlevel.spectral_flatness_db.compute");
+    desc.barkBandsMoments    = boolOption(pool, "lowlevel.barkbands_moments.compute");
+    desc.spectralComplexity  = boolOption(pool, "lowlevel.spectral_complexity.compute");
+    desc.pitch               = boolOption(pool, "lowlevel.pitch.compute");
+    desc.pitchSalience       = boolOption(pool, "lowlevel.pitch_salience.compute");
+}
+
+SpectralDescriptors neededSpectral(const SpectralDescriptors &requested,
+                                   const DescriptorOptions &desc, bool segmentation)
+{
+    SpectralDescriptors needed = SpectralDescriptors();
+
+    if (desc.lowlevel) needed = requested;
+
+    // the segments are found on the MFCCs
+    if (segmentation) needed.mfcc = true;
+
+    // SFXPitch and the harmonic peaks need the pitch
+    if (desc.sfx) needed.pitch = true;
+
+    return needed;
+}
+
+} // namespace
+
+void parseOptions(AnalysisOptions &options, const Pool &config)
+{
+    Pool pool;
+    Pool tmpOptions = config;
+
+    setDefaultOptions(pool);
+
+    pool.merge(tmpOptions, "replace");
+
+    // general
+    options.equalLoudness      = boolOption(pool, "equalLoudness");
+    options.nequalLoudness     = boolOption(pool, "nequalLoudness");
+    options.endTime            = realOption(pool, "endTime", "(0,inf)");
+    options.startTime          = realOption(pool, "startTime", "[0,inf)");
+    options.analysisSampleRate = realOption(pool, "analysisSampleRate", "(0,inf)");
+    options.equalOutputPath    = stringOption(pool, "equalOutputPath");
+    options.nequalOutputPath   = stringOption(pool, "nequalOutputPath");
+    options.outputFormat       = stringOption(pool, "outputFormat", "{yaml,json,binary}");
+    options.outputAsync        = boolOption(pool, "outputAsync");
+    options.skipReplayGain     = boolOption(pool, "skipReplayGain");
+
+    if (options.equalLoudness == options.nequalLoudness)
+    {
+        throw EssentiaException("Configuration for both equal loudness and non\
+           equal loudness is set to false or true. At least and only one must be set to true");
+    }
+
+    if (options.startTime >= options.endTime)
+    {
+        throw EssentiaException("Option startTime must be lower than endTime");
+    }
+
+    parseDescriptors(options.track, pool, "");
+    parseDescriptors(options.segment, pool, "segmentation.desc.");
+
+    // segmentation
+    options.segmentation.compute               = boolOption(pool, "segmentation.compute");
+    options.segmentation.size1                 = intOption(pool, "segmentation.size1", "[1,inf)");
+    options.segmentation.inc1                  = intOption(pool, "segmentation.inc1", "[1,inf)");
+    options.segmentation.size2                 = intOption(pool, "segmentation.size2", "[1,inf)");
+    options.segmentation.inc2                  = intOption(pool, "segmentation.inc2", "[1,inf)");
+    options.segmentation.cpw                   = realOption(pool, "segmentation.cpw", "[0,inf)");
+    options.segmentation.minimumSegmentsLength = intOption(pool, "segmentation.minimumSegmentsLength", "[1,inf)");
+
+    options.trackPasses.plan(options.track, options.segmentation.compute);
+    options.segmentPasses.plan(options.segment, false);
+
+    // average_loudness
+    parseFrame(options.averageLoudness, pool, "average_loudness");
+
+    // rhythm
+    options.beats.method   = stringOption(pool, "rhythm.beats.method", "{multifeature,degara}");
+    options.beats.minTempo = realOption(pool, "rhythm.beats.minTempo", "[40,180]");
+    options.beats.maxTempo = realOption(pool, "rhythm.beats.maxTempo", "[60,250]");
+
+    options.danceability.minTau        = realOption(pool, "rhythm.danceability.minTau", "(0,inf)");
+    options.danceability.maxTau        = realOption(pool, "rhythm.danceability.maxTau", "(0,inf)");
+    options.danceability.tauMultiplier = realOption(pool, "rhythm.danceability.tauMultiplier", "[1,inf)");
+
+    // fades
+    options.fades.frameSize    = intOption(pool, "fades.frameSize", "[1,inf)");
+    options.fades.hopSize      = intOption(pool, "fades.hopSize", "[1,inf)");
+    options.fades.frameRate    = realOption(pool, "fades.frameRate", "(0,inf)");
+    options.fades.minLength    = realOption(pool, "fades.minLength", "(0,inf)");
+    options.fades.cutoffHigh   = realOption(pool, "fades.cutoffHigh", "(0,1]");
+    options.fades.cutoffLow    = realOption(pool, "fades.cutoffLow", "[0,1)");
+    options.fades.silentFrames = stringOption(pool, "fades.silentFrames", silentFrameModes);
+
+    // lowlevel, tonal
+    parseFrame(options.lowlevel, pool, "lowlevel");
+    parseFrame(options.tonal, pool, "tonal");
+
+    parseSpectral(options.spectralRequested, pool);
+    options.trackSpectral   = neededSpectral(options.spectralRequested, options.track, options.segmentation.compute);
+    options.segmentSpectral = neededSpectral(options.spectralRequested, options.segment, false);
+
+    // panning
+    parseFrame(options.panning.frame, pool, "panning");
+    options.panning.averageFrames  = intOption(pool, "panning.averageFrames", "[0,inf)");
+    options.panning.panningBins    = intOption(pool, "panning.panningBins", "(1,inf)");
+    options.panning.numCoeffs      = intOption(pool, "panning.numCoeffs", "(0,inf)");
+    options.panning.numBands       = intOption(pool, "panning.numBands", "[1,inf)");
+    options.panning.warpedPanorama = boolOption(pool, "panning.warpedPanorama");
+
+    // svm
+    options.svm = boolOption(pool, "svm.compute");
+
+    // stats
+    options.stats.lowlevel = pool.value<vector<string> >("lowlevel.stats");
+    options.stats.mfcc     = pool.value<vector<string> >("lowlevel.mfccStats");
+    options.stats.tonal    = pool.value<vector<string> >("tonal.stats");
+    options.stats.rhythm   = pool.value<vector<string> >("rhythm.stats");
+    options.stats.sfx      = pool.value<vector<string> >("sfx.stats");
+    options.stats.panning  = pool.value<vector<string> >("panning.stats");
+    options.stats.fades    = pool.value<vector<string> >("fades.stats");
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef ANALYSIS_OPTIONS_H
+#define ANALYSIS_OPTIONS_H
+
+#include "pass_schedule.h"
+
+#include <pool.h>
+#include <types.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace essentia;
+
+// frame cutting and windowing of one extractor
+struct FrameOptions
+{
+    int frameSize;
+    int hopSize;
+    int zeroPadding;
+    string windowType;
+    string silentFrames;
+};
+
+// the <name>.compute switches, once for the whole track and once for the
+// segments (segmentation.desc.<name>.compute)
+struct DescriptorOptions
+{
+    bool lowlevel;
+    bool averageLoudness;
+    bool beats;
+    bool beatsLoudness;
+    bool bpmHistogram;
+    bool onset;
+    bool danceability;
+    bool tonal;
+    bool sfx;
+    bool panning;
+    bool fades;
+};
+
+// the descriptors of LowLevelSpectral, lowlevel.<descriptor>.compute
+struct SpectralDescriptors
+{
+    bool silenceRate;
+    bool zeroCrossingRate;
+    bool mfcc;
+    bool spectralDecrease;
+    bool spectralEnergy;
+    bool spectralEnergyBands;
+    bool hfc;
+    bool frequencyBands;
+    bool spectralRms;
+    bool spectralFlux;
+    bool spectralRolloff;
+    bool spectralStrongPeak;
+    bool barkBands;
+    bool spectralCrest;
+    bool spectralFlatnessDb;
+    bool barkBandsMoments;
+    bool spectralComplexity;
+    bool pitch;
+    bool pitchSalience;
+};
+
+// typed copy of the option pool, see setDefaultOptions for the meaning and
+// the domain of every value
+struct AnalysisOptions
+{
+    // general
+    bool equalLoudness;
+    bool nequalLoudness;
+    Real startTime;
+    Real endTime;
+    Real analysisSampleRate;
+    string equalOutputPath;
+    string nequalOutputPath;
+    string outputFormat;
+    bool outputAsync;
+    bool skipReplayGain;
+
+    DescriptorOptions track;
+    DescriptorOptions segment;
+
+    // returns the compute switches of the track ("") or of a segment namespace
+    const DescriptorOptions &compute(const string &nspace) const
+    {
+        return nspace.empty() ? track : segment;
+    }
+
+    // the stages and passes needed for the switches above
+    PassSchedule trackPasses;
+    PassSchedule segmentPasses;
+
+    const PassSchedule &passes(const string &nspace) const
+    {
+        return nspace.empty() ? trackPasses : segmentPasses;
+    }
+
+    struct
+    {
+        bool compute;
+        int size1;
+        int inc1;
+        int size2;
+        int inc2;
+        Real cpw;
+        int minimumSegmentsLength;
+    } segmentation;
+
+    FrameOptions averageLoudness; // zeroPadding is not used
+
+    struct
+    {
+        string method;
+        Real minTempo;
+        Real maxTempo;
+    } beats;
+
+    struct
+    {
+        Real minTau;
+        Real maxTau;
+        Real tauMultiplier;
+    } danceability;
+
+    struct
+    {
+        int frameSize;
+        int hopSize;
+        Real frameRate;
+        Real minLength;
+        Real cutoffHigh;
+        Real cutoffLow;
+        string silentFrames;
+    } fades;
+
+    FrameOptions lowlevel;
+    FrameOptions tonal;
+
+    // the configured lowlevel descriptors
+    SpectralDescriptors spectralRequested;
+
+    // what LowLevelSpectral computes for the track and the segments: the
+    // configured descriptors if lowlevel is requested, plus the ones other
+    // stages read (mfcc for the segmentation, pitch for sfx)
+    SpectralDescriptors trackSpectral;
+    SpectralDescriptors segmentSpectral;
+
+    const SpectralDescriptors &spectral(const string &nspace) const
+    {
+        return nspace.empty() ? trackSpectral : segmentSpectral;
+    }
+
+    struct
+    {
+        FrameOptions frame;
+        int averageFrames;
+        int panningBins;
+        int numCoeffs;
+        int numBands;
+        bool warpedPanorama;
+    } panning;
+
+    bool svm;
+
+    struct
+    {
+        vector<string> lowlevel;
+        vector<string> mfcc;
+        vector<string> tonal;
+        vector<string> rhythm;
+        vector<string> sfx;
+        vector<string> panning;
+        vector<string> fades;
+    } stats;
+};
+
+/**
+ * @brief Merges the configuration into the default options and converts them
+ * into an AnalysisOptions struct. Throws an EssentiaException if a value is
+ * outside of its documented domain.
+ */
+void parseOptions(AnalysisOptions &options, const Pool &config);
+
+#endif // ANALYSIS_OPTIONS_H
@@ -22,6 +22,9 @@
 
 #include "config_util.h"
 
+#include <algorithm>
+
+#include "../writer/BinaryOutput.h"
 #include "../writer/YamlOutput.h"
 
 #include "streaming/algorithms/poolstorage.h"
@@ -42,7 +45,8 @@ void setDefaultOptions(Pool &pool)
 
     pool.set("equalOutputPath", "");                        // string                           | equal result output to file
     pool.set("nequalOutputPath", "");                       // string                           | nequal result output to file
-    pool.set("outputFormat", "json");                       // {yaml,json}                      | result output format
+    pool.set("outputFormat", "json");                       // {yaml,json,binary}               | result output format
+    pool.set("outputAsync", false);                         // {false,true}                     | write the output files on a background thread, see essentia_flush_output
 
     pool.set("skipReplayGain", false);                      // {false,true}                     | if true use standard values, saves some time, possibly different results
 
@@ -106,6 +110,27 @@ void setDefaultOptions(Pool &pool)
     //  blackmanharris62/70/74/92}
     pool.set("lowlevel.silentFrames", "noise");             // {drop,keep,noise}                | whether to [keep/drop/add noise to] silent frames
 
+    // lowlevel descriptors, only computed if lowlevel.compute is set
+    pool.set("lowlevel.silence_rate.compute", true);        // {false,true}                     | silence_rate_20dB/30dB/60dB
+    pool.set("lowlevel.zerocrossingrate.compute", true);    // {false,true}                     | zerocrossingrate
+    pool.set("lowlevel.mfcc.compute", true);                // {false,true}                     | mfcc, always computed for segmentation
+    pool.set("lowlevel.spectral_decrease.compute", true);   // {false,true}                     | spectral_decrease
+    pool.set("lowlevel.spectral_energy.compute", true);     // {false,true}                     | spectral_energy
+    pool.set("lowlevel.spectral_energyband.compute", true); // {false,true}                     | spectral_energyband_low/middle_low/middle_high/high
+    pool.set("lowlevel.hfc.compute", true);                 // {false,true}                     | hfc
+    pool.set("lowlevel.frequency_bands.compute", true);     // {false,true}                     | frequency_bands
+    pool.set("lowlevel.spectral_rms.compute", true);        // {false,true}                     | spectral_rms
+    pool.set("lowlevel.spectral_flux.compute", true);       // {false,true}                     | spectral_flux
+    pool.set("lowlevel.spectral_rolloff.compute", true);    // {false,true}                     | spectral_rolloff
+    pool.set("lowlevel.spectral_strongpeak.compute", true); // {false,true}                     | spectral_strongpeak
+    pool.set("lowlevel.barkbands.compute", true);           // {false,true}                     | barkbands
+    pool.set("lowlevel.spectral_crest.compute", true);      // {false,true}                     | spectral_crest
+    pool.set("lowlevel.spectral_flatness_db.compute", true); // {false,true}                    | spectral_flatness_db
+    pool.set("lowlevel.barkbands_moments.compute", true);   // {false,true}                     | barkbands_kurtosis/spread/skewness
+    pool.set("lowlevel.spectral_complexity.compute", true); // {false,true}                     | spectral_complexity
+    pool.set("lowlevel.pitch.compute", true);               // {false,true}                     | pitch and pitch_instantaneous_confidence, always computed for sfx
+    pool.set("lowlevel.pitch_salience.compute", true);      // {false,true}                     | pitch_salience
+
     // tonal
     pool.set("tonal.compute", false);                       // {false,true}                     | compute some tonal things
     pool.set("tonal.frameSize", 4096);                      // [1,inf)                          | the size of the frame to cut
@@ -149,6 +174,8 @@ void setDefaultOptions(Pool &pool)
     pool.set("segmentation.desc.fades.compute", false);     // {false,true}                     | compute fades descriptors for segments
 
     // stats
+    // the median of a streamed descriptor is exact up to 32767 frames (about 12 minutes of low level
+    // frames at 44.1 kHz), it is approximated for longer recordings
     // const char *statsArray[] = { "mean", "var", "median", "min", "max", "dmean", "dmean2", "dvar", "dvar2" };
     const char *statsArray[] = {"mean", "var", "median", "min", "max", "dmean", "dmean2", "dvar", "dvar2"};
 
@@ -170,135 +197,175 @@ void setDefaultOptions(Pool &pool)
     pool.add("fades.stats", "copy");
 }
 
-void mergeOptionsAndResults(Pool &results, const Pool &options)
+void mergeOptionsAndResults(Pool &results, const AnalysisOptions &options)
 {
     // merges the configuration results with results pool
-    results.set("configuration.general.equalLoudness",        options.value<Real>("equalLoudness"));
-    results.set("configuration.general.nequalLoudness",       options.value<Real>("nequalLoudness"));
+    results.set("configuration.general.equalLoudness",        options.equalLoudness);
+    results.set("configuration.general.nequalLoudness",       options.nequalLoudness);
 
-    results.set("configuration.general.startTime",            options.value<Real>("startTime"));
-    results.set("configuration.general.endTime",              options.value<Real>("endTime"));
-    results.set("configuration.general.analysisSampleRate",   options.value<Real>("analysisSampleRate"));
+    results.set("configuration.general.startTime",            options.startTime);
+    results.set("configuration.general.endTime",              options.endTime);
+    results.set("configuration.general.analysisSampleRate",   options.analysisSampleRate);
 
-    results.set("configuration.general.equalOutputPath",      options.value<string>("equalOutputPath"));
-    results.set("configuration.general.nequalOutputPath",     options.value<string>("nequalOutputPath"));
-    results.set("configuration.general.outputFormat",         options.value<string>("outputFormat"));
+    results.set("configuration.general.equalOutputPath",      options.equalOutputPath);
+    results.set("configuration.general.nequalOutputPath",     options.nequalOutputPath);
+    results.set("configuration.general.outputFormat",         options.outputFormat);
+    results.set("configuration.general.outputAsync",          options.outputAsync);
 
-    results.set("configuration.general.skipReplayGain",       options.value<Real>("skipReplayGain"));
+    results.set("configuration.general.skipReplayGain",       options.skipReplayGain);
 
     // segmentation
-    results.set("configuration.segmentation.compute",               options.value<Real>("segmentation.compute"));
-    results.set("configuration.segmentation.size1",                 options.value<Real>("segmentation.size1"));
-    results.set("configuration.segmentation.inc1",                  options.value<Real>("segmentation.inc1"));
-    results.set("configuration.segmentation.size2",                 options.value<Real>("segmentation.size2"));
-    results.set("configuration.segmentation.inc2",                  options.value<Real>("segmentation.inc2"));
-    results.set("configuration.segmentation.cpw",                   options.value<Real>("segmentation.cpw"));
-    results.set("configuration.segmentation.minimumSegmentsLength", options.value<Real>("segmentation.minimumSegmentsLength"));
+    results.set("configuration.segmentation.compute",               options.segmentation.compute);
+    results.set("configuration.segmentation.size1",                 options.segmentation.size1);
+    results.set("configuration.segmentation.inc1",                  options.segmentation.inc1);
+    results.set("configuration.segmentation.size2",                 options.segmentation.size2);
+    results.set("configuration.segmentation.inc2",                  options.segmentation.inc2);
+    results.set("configuration.segmentation.cpw",                   options.segmentation.cpw);
+    results.set("configuration.segmentation.minimumSegmentsLength", options.segmentation.minimumSegmentsLength);
 
     // average_loudness
-    results.set("configuration.average_loudness.compute",      options.value<Real>("average_loudness.compute"));
-    results.set("configuration.average_loudness.frameSize",    options.value<Real>("average_loudness.frameSize"));
-    results.set("configuration.average_loudness.hopSize",      options.value<Real>("average_loudness.hopSize"));
-    results.set("configuration.average_loudness.windowType",   options.value<string>("average_loudness.windowType"));
-    results.set("configuration.average_loudness.silentFrames", options.value<string>("average_loudness.silentFrames"));
+    results.set("configuration.average_loudness.compute",      options.track.averageLoudness);
+    results.set("configuration.average_loudness.frameSize",    options.averageLoudness.frameSize);
+    results.set("configuration.average_loudness.hopSize",      options.averageLoudness.hopSize);
+    results.set("configuration.average_loudness.windowType",   options.averageLoudness.windowType);
+    results.set("configuration.average_loudness.silentFrames", options.averageLoudness.silentFrames);
 
     // rhythm
-    results.set("configuration.rhythm.beats.compute",   options.value<Real>("rhythm.beats.compute"));
-    results.set("configuration.rhythm.beats.method",    options.value<string>("rhythm.beats.method"));
-    results.set("configuration.rhythm.beats.minTempo",  options.value<Real>("rhythm.beats.minTempo"));
-    results.set("configuration.rhythm.beats.maxTempo",  options.value<Real>("rhythm.beats.maxTempo"));
+    results.set("configuration.rhythm.beats.compute",   options.track.beats);
+    results.set("configuration.rhythm.beats.method",    options.beats.method);
+    results.set("configuration.rhythm.beats.minTempo",  options.beats.minTempo);
+    results.set("configuration.rhythm.beats.maxTempo",  options.beats.maxTempo);
 
-    results.set("configuration.rhythm.beats.loudness.compute",   options.value<Real>("rhythm.beats.loudness.compute"));
-    results.set("configuration.rhythm.bpmhistogram.compute",    options.value<Real>("rhythm.bpmhistogram.compute"));
-    results.set("configuration.rhythm.onset.compute",           options.value<Real>("rhythm.onset.compute"));
+    results.set("configuration.rhythm.beats.loudness.compute",   options.track.beatsLoudness);
+    results.set("configuration.rhythm.bpmhistogram.compute",    options.track.bpmHistogram);
+    results.set("configuration.rhythm.onset.compute",           options.track.onset);
 
-    results.set("configuration.rhythm.danceability.compute",        options.value<Real>("rhythm.danceability.compute"));
-    results.set("configuration.rhythm.danceability.minTau",         options.value<Real>("rhythm.danceability.minTau"));
-    results.set("configuration.rhythm.danceability.maxTau",         options.value<Real>("rhythm.danceability.maxTau"));
-    results.set("configuration.rhythm.danceability.tauMultiplier",  options.value<Real>("rhythm.danceability.tauMultiplier"));
+    results.set("configuration.rhythm.danceability.compute",        options.track.danceability);
+    results.set("configuration.rhythm.danceability.minTau",         options.danceability.minTau);
+    results.set("configuration.rhythm.danceability.maxTau",         options.danceability.maxTau);
+    results.set("configuration.rhythm.danceability.tauMultiplier",  options.danceability.tauMultiplier);
 
     // fades
-    results.set("configuration.fades.compute",        options.value<Real>("fades.compute"));
-    results.set("configuration.fades.frameSize",      options.value<Real>("fades.frameSize"));
-    results.set("configuration.fades.hopSize",        options.value<Real>("fades.hopSize"));
-    results.set("configuration.fades.minLength",      options.value<Real>("fades.minLength"));
-    results.set("configuration.fades.cutoffHigh",     options.value<Real>("fades.cutoffHigh"));
-    results.set("configuration.fades.cutoffLow",      options.value<Real>("fades.cutoffLow"));
-    results.set("configuration.fades.silentFrames",   options.value<string>("fades.silentFrames"));
+    results.set("configuration.fades.compute",        options.track.fades);
+    results.set("configuration.fades.frameSize",      options.fades.frameSize);
+    results.set("configuration.fades.hopSize",        options.fades.hopSize);
+    results.set("configuration.fades.minLength",      options.fades.minLength);
+    results.set("configuration.fades.cutoffHigh",     options.fades.cutoffHigh);
+    results.set("configuration.fades.cutoffLow",      options.fades.cutoffLow);
+    results.set("configuration.fades.silentFrames",   options.fades.silentFrames);
 
     // lowlevel
-    results.set("configuration.lowlevel.compute",      options.value<Real>("lowlevel.compute"));
-    results.set("configuration.lowlevel.frameSize",    options.value<Real>("lowlevel.frameSize"));
-    results.set("configuration.lowlevel.hopSize",      options.value<Real>("lowlevel.hopSize"));
-    results.set("configuration.lowlevel.zeroPadding",  options.value<Real>("lowlevel.zeroPadding"));
-    results.set("configuration.lowlevel.windowType",   options.value<string>("lowlevel.windowType"));
-    results.set("configuration.lowlevel.silentFrames", options.value<string>("lowlevel.silentFrames"));
+    results.set("configuration.lowlevel.compute",      options.track.lowlevel);
+    results.set("configuration.lowlevel.frameSize",    options.lowlevel.frameSize);
+    results.set("configuration.lowlevel.hopSize",      options.lowlevel.hopSize);
+    results.set("configuration.lowlevel.zeroPadding",  options.lowlevel.zeroPadding);
+    results.set("configuration.lowlevel.windowType",   options.lowlevel.windowType);
+    results.set("configuration.lowlevel.silentFrames", options.lowlevel.silentFrames);
+
+    const SpectralDescriptors &spectral = options.spectralRequested;
+    results.set("configuration.lowlevel.silence_rate.compute",         spectral.silenceRate);
+    results.set("configuration.lowlevel.zerocrossingrate.compute",     spectral.zeroCrossingRate);
+    results.set("configuration.lowlevel.mfcc.compute",                 spectral.mfcc);
+    results.set("configuration.lowlevel.spectral_decrease.compute",    spectral.spectralDecrease);
+    results.set("configuration.lowlevel.spectral_energy.compute",      spectral.spectralEnergy);
+    results.set("configuration.lowlevel.spectral_energyband.compute",  spectral.spectralEnergyBands);
+    results.set("configuration.lowlevel.hfc.compute",                  spectral.hfc);
+    results.set("configuration.lowlevel.frequency_bands.compute",      spectral.frequencyBands);
+    results.set("configuration.lowlevel.spectral_rms.compute",         spectral.spectralRms);
+    results.set("configuration.lowlevel.spectral_flux.compute",        spectral.spectralFlux);
+    results.set("configuration.lowlevel.spectral_rolloff.compute",     spectral.spectralRolloff);
+    results.set("configuration.lowlevel.spectral_strongpeak.compute",  spectral.spectralStrongPeak);
+    results.set("configuration.lowlevel.barkbands.compute",            spectral.barkBands);
+    results.set("configuration.lowlevel.spectral_crest.compute",       spectral.spectralCrest);
+    results.set("configuration.lowlevel.spectral_flatness_db.compute", spectral.spectralFlatnessDb);
+    results.set("configuration.lowlevel.barkbands_moments.compute",    spectral.barkBandsMoments);
+    results.set("configuration.lowlevel.spectral_complexity.compute",  spectral.spectralComplexity);
+    results.set("configuration.lowlevel.pitch.compute",                spectral.pitch);
+    results.set("configuration.lowlevel.pitch_salience.compute",       spectral.pitchSalience);
 
     // tonal
-    results.set("configuration.tonal.compute",      options.value<Real>("tonal.compute"));
-    results.set("configuration.tonal.frameSize",    options.value<Real>("tonal.frameSize"));
-    results.set("configuration.tonal.hopSize",      options.value<Real>("tonal.hopSize"));
-    results.set("configuration.tonal.zeroPadding",  options.value<Real>("tonal.zeroPadding"));
-    results.set("configuration.tonal.windowType",   options.value<string>("tonal.windowType"));
-    results.set("configuration.tonal.silentFrames", options.value<string>("tonal.silentFrames"));
+    results.set("configuration.tonal.compute",      options.track.tonal);
+    results.set("configuration.tonal.frameSize",    options.tonal.frameSize);
+    results.set("configuration.tonal.hopSize",      options.tonal.hopSize);
+    results.set("configuration.tonal.zeroPadding",  options.tonal.zeroPadding);
+    results.set("configuration.tonal.windowType",   options.tonal.windowType);
+    results.set("configuration.tonal.silentFrames", options.tonal.silentFrames);
 
     // sfx
-    results.set("configuration.sfx.compute", options.value<Real>("sfx.compute"));
+    results.set("configuration.sfx.compute", options.track.sfx);
 
     // panning
-    results.set("configuration.panning.compute",        options.value<Real>("panning.compute"));
-    results.set("configuration.panning.frameSize",      options.value<Real>("panning.frameSize"));
-    results.set("configuration.panning.hopSize",        options.value<Real>("panning.hopSize"));
-    results.set("configuration.panning.averageFrames",  options.value<Real>("panning.averageFrames"));
-    results.set("configuration.panning.panningBins",    options.value<Real>("panning.panningBins"));
-    results.set("configuration.panning.numCoeffs",      options.value<Real>("panning.numCoeffs"));
-    results.set("configuration.panning.numBands",       options.value<Real>("panning.numBands"));
-    results.set("configuration.panning.warpedPanorama", options.value<Real>("panning.warpedPanorama"));
-    results.set("configuration.panning.zeroPadding",    options.value<Real>("panning.zeroPadding"));
-    results.set("configuration.panning.windowType",     options.value<string>("panning.windowType"));
-    results.set("configuration.panning.silentFrames",   options.value<string>("panning.silentFrames"));
+    results.set("configuration.panning.compute",        options.track.panning);
+    results.set("configuration.panning.frameSize",      options.panning.frame.frameSize);
+    results.set("configuration.panning.hopSize",        options.panning.frame.hopSize);
+    results.set("configuration.panning.averageFrames",  options.panning.averageFrames);
+    results.set("configuration.panning.panningBins",    options.panning.panningBins);
+    results.set("configuration.panning.numCoeffs",      options.panning.numCoeffs);
+    results.set("configuration.panning.numBands",       options.panning.numBands);
+    results.set("configuration.panning.warpedPanorama", options.panning.warpedPanorama);
+    results.set("configuration.panning.zeroPadding",    options.panning.frame.zeroPadding);
+    results.set("configuration.panning.windowType",     options.panning.frame.windowType);
+    results.set("configuration.panning.silentFrames",   options.panning.frame.silentFrames);
 
     // svm
-    results.set("configuration.svm.compute",          options.value<Real>("svm.compute"));
+    results.set("configuration.svm.compute",          options.svm);
 
     // segment descriptors
-    results.set("configuration.segmentation.desc.lowlevel.compute",               options.value<Real>("segmentation.desc.lowlevel.compute"));
-    results.set("configuration.segmentation.desc.average_loudness.compute",       options.value<Real>("segmentation.desc.average_loudness.compute"));
-    results.set("configuration.segmentation.desc.rhythm.beats.compute",           options.value<Real>("segmentation.desc.rhythm.beats.compute"));
-    results.set("configuration.segmentation.desc.rhythm.beats.loudness.compute",  options.value<Real>("segmentation.desc.rhythm.beats.loudness.compute"));
-    results.set("configuration.segmentation.desc.rhythm.bpmhistogram.compute",    options.value<Real>("segmentation.desc.rhythm.bpmhistogram.compute"));
-    results.set("configuration.segmentation.desc.rhythm.onset.compute",           options.value<Real>("segmentation.desc.rhythm.onset.compute"));
-    results.set("configuration.segmentation.desc.rhythm.danceability.compute",    options.value<Real>("segmentation.desc.rhythm.danceability.compute"));
-    results.set("configuration.segmentation.desc.tonal.compute",                  options.value<Real>("segmentation.desc.tonal.compute"));
-    results.set("configuration.segmentation.desc.sfx.compute",                    options.value<Real>("segmentation.desc.sfx.compute"));
-    results.set("configuration.segmentation.desc.panning.compute",                options.value<Real>("segmentation.desc.panning.compute"));
-    results.set("configuration.segmentation.desc.fades.compute",                  options.value<Real>("segmentation.desc.fades.compute"));
+    results.set("configuration.segmentation.desc.lowlevel.compute",               options.segment.lowlevel);
+    results.set("configuration.segmentation.desc.average_loudness.compute",       options.segment.averageLoudness);
+    results.set("configuration.segmentation.desc.rhythm.beats.compute",           options.segment.beats);
+    results.set("configuration.segmentation.desc.rhythm.beats.loudness.compute",  options.segment.beatsLoudness);
+    results.set("configuration.segmentation.desc.rhythm.bpmhistogram.compute",    options.segment.bpmHistogram);
+    results.set("configuration.segmentation.desc.rhythm.onset.compute",           options.segment.onset);
+    results.set("configuration.segmentation.desc.rhythm.danceability.compute",    options.segment.danceability);
+    results.set("configuration.segmentation.desc.tonal.compute",                  options.segment.tonal);
+    results.set("configuration.segmentation.desc.sfx.compute",                    options.segment.sfx);
+    results.set("configuration.segmentation.desc.panning.compute",                options.segment.panning);
+    results.set("configuration.segmentation.desc.fades.compute",                  options.segment.fades);
 
     // stats
-    vector<string> lowlevelStats = options.value<vector<string> >("lowlevel.stats");
+    const vector<string> &lowlevelStats = options.stats.lowlevel;
     for (int i = 0; i < (int)lowlevelStats.size(); i++) results.add("configuration.lowlevel.stats", lowlevelStats[i]);
 
-    vector<string> tonalStats = options.value<vector<string> >("tonal.stats");
+    const vector<string> &tonalStats = options.stats.tonal;
     for (int i = 0; i < (int)tonalStats.size(); i++) results.add("configuration.tonal.stats", tonalStats[i]);
 
-    vector<string> rhythmStats = options.value<vector<string> >("rhythm.stats");
+    const vector<string> &rhythmStats = options.stats.rhythm;
     for (int i = 0; i < (int)rhythmStats.size(); i++) results.add("configuration.rhythm.stats", rhythmStats[i]);
 
-    vector<string> sfxStats = options.value<vector<string> >("sfx.stats");
+    const vector<string> &sfxStats = options.stats.sfx;
     for (int i = 0; i < (int)sfxStats.size(); i++) results.add("configuration.sfx.stats", sfxStats[i]);
 
-    vector<string> mfccStats = options.value<vector<string> >("lowlevel.mfccStats");
+    const vector<string> &mfccStats = options.stats.mfcc;
     for (int i = 0; i < (int)mfccStats.size(); i++) results.add("configuration.lowlevel.mfccStats", mfccStats[i]);
 
-    vector<string> panningStats = options.value<vector<string> >("panning.stats");
+    const vector<string> &panningStats = options.stats.panning;
     for (int i = 0; i < (int)panningStats.size(); i++) results.add("configuration.panning.stats", panningStats[i]);
 
-    vector<string> fadeStats = options.value<vector<string> >("fades.stats");
+    const vector<string> &fadeStats = options.stats.fades;
     for (int i = 0; i < (int)fadeStats.size(); i++) results.add("configuration.fades.stats", fadeStats[i]);
 
 }
 
-Pool computeAggregation(Pool &pool, const Pool &options, int nSegments)
+namespace {
+
+// the statistics of a descriptor, by namespace
+const vector<string> *descriptorStats(const string &name, const AnalysisOptions &options)
+{
+    if (name.find("lowlevel.mfcc") != string::npos) return &options.stats.mfcc;
+    if (name.find("lowlevel.") != string::npos) return &options.stats.lowlevel;
+    if (name.find("rhythm.") != string::npos) return &options.stats.rhythm;
+    if (name.find("tonal.") != string::npos) return &options.stats.tonal;
+    if (name.find("sfx.") != string::npos) return &options.stats.sfx;
+    if (name.find("panning.") != string::npos) return &options.stats.panning;
+    if (name.find("fades.") != string::npos) return &options.stats.fades;
+    return nullptr;
+}
+
+}
+
+Pool computeAggregation(Pool &pool, const AnalysisOptions &options, int nSegments,
+                        const essentiawrapper::DescriptorStatistics *frameStats)
 {
     cout << "Process step 8: Aggregation" << endl;
 
@@ -309,41 +376,8 @@ Pool computeAggregation(Pool &pool, const Pool &options, int nSegments)
     const vector<string> &descNames = pool.descriptorNames();
     for (int i = 0; i < (int)descNames.size(); i++)
     {
-        if (descNames[i].find("lowlevel.mfcc") != string::npos)
-        {
-            exceptions[descNames[i]] = options.value<vector<string> >("lowlevel.mfccStats");
-            continue;
-        }
-        if (descNames[i].find("lowlevel.") != string::npos)
-        {
-            exceptions[descNames[i]] = options.value<vector<string> >("lowlevel.stats");
-            continue;
-        }
-        if (descNames[i].find("rhythm.") != string::npos)
-        {
-            exceptions[descNames[i]] = options.value<vector<string> >("rhythm.stats");
-            continue;
-        }
-        if (descNames[i].find("tonal.") != string::npos)
-        {
-            exceptions[descNames[i]] = options.value<vector<string> >("tonal.stats");
-            continue;
-        }
-        if (descNames[i].find("sfx.") != string::npos)
-        {
-            exceptions[descNames[i]] = options.value<vector<string> >("sfx.stats");
-            continue;
-        }
-        if (descNames[i].find("panning.") != string::npos)
-        {
-            exceptions[descNames[i]] = options.value<vector<string> >("panning.stats");
-            continue;
-        }
-        if (descNames[i].find("fades.") != string::npos)
-        {
-            exceptions[descNames[i]] = options.value<vector<string> >("fades.stats");
-            continue;
-        }
+        const vector<string> *stats = descriptorStats(descNames[i], options);
+        if (stats) exceptions[descNames[i]] = *stats;
     }
 
     // in case there is segmentation:
@@ -362,10 +396,26 @@ Pool computeAggregation(Pool &pool, const Pool &options, int nSegments)
 
     aggregator->compute();
 
+    // the descriptors aggregated while streaming, their frames are not in
+    // the pool
+    if (frameStats)
+    {
+        essentiawrapper::DescriptorRegistry &registry = essentiawrapper::DescriptorRegistry::instance();
+
+        for (const auto &entry : frameStats->descriptors().entries())
+        {
+            if (entry.pool != &pool) continue;
+
+            const string &name = registry.name(entry.id);
+            const vector<string> *stats = descriptorStats(name, options);
+            entry.value.aggregate(poolStats, name, stats ? *stats : arrayToVector<string>(defaultStats));
+        }
+    }
+
     return poolStats;
 }
 
-void cleanUp(Pool &pool, const Pool &options)
+void cleanUp(Pool &pool, const AnalysisOptions &options)
 {
 
     cout << "clean up " << endl;
@@ -374,13 +424,12 @@ void cleanUp(Pool &pool, const Pool &options)
     // should not contain lowlevel features. The rest of namespaces should
     // only be computed if they were set explicitly in the config file
 
-    if (options.value<Real>("lowlevel.compute") == 0)
+    if (!options.track.lowlevel)
     {
         pool.removeNamespace("lowlevel");
     }
 
-    if (options.value<Real>("segmentation.compute") != 0 &&
-            options.value<Real>("segmentation.desc.lowlevel.compute") == 0)
+    if (options.segmentation.compute && !options.segment.lowlevel)
     {
         ostringstream ns;
         vector<Real> segments = pool.value<vector<Real> >("segmentation.timestamps");
@@ -397,64 +446,98 @@ void cleanUp(Pool &pool, const Pool &options)
 
 }
 
-void outputToFile(Pool &pool, const string &outputFilename, const Pool &options)
+void prepareOutput(Pool &pool, const AnalysisOptions &options)
 {
-    if (!outputFilename.empty())
-    {
-        cout << "Writing results to file " << outputFilename << endl;
-        // some descriptors depend on lowlevel descriptors but it might be that the
-        // config file was set lowlevel.compute: false. In this case, the ouput
-        // file should not contain lowlevel features. The rest of namespaces should
-        // only be computed if they were set explicitly in the config file
-        if (options.value<Real>("lowlevel.compute") == 0) pool.removeNamespace("lowlevel");
+    // some descriptors depend on lowlevel descriptors but it might be that the
+    // config file was set lowlevel.compute: false. In this case, the ouput
+    // file should not contain lowlevel features. The rest of namespaces should
+    // only be computed if they were set explicitly in the config file
+    if (!options.track.lowlevel) pool.removeNamespace("lowlevel");
 
-        // TODO: merge results pool with options pool so configuration is also
-        // available in the output file
-        mergeOptionsAndResults(pool, options);
+    // TODO: merge results pool with options pool so configuration is also
+    // available in the output file
+    mergeOptionsAndResults(pool, options);
+}
 
-        ostringstream ns(options.value<string>("outputFormat"));
-        string format = ns.str();
+void writeOutput(const Pool &pool, const string &outputFilename, const string &format)
+{
+    cout << "Writing results to file " << outputFilename << endl;
 
-        shared_ptr<standard::Algorithm> output(new essentiawrapper::YamlOutput());
+    shared_ptr<standard::Algorithm> output;
+    if (format == "binary")
+    {
+        output.reset(new essentiawrapper::BinaryOutput());
+        output->declareParameters();
+        output->configure("filename", outputFilename,
+                          "doubleCheck", true);
+    }
+    else
+    {
+        output.reset(new essentiawrapper::YamlOutput());
         output->declareParameters();
         output->configure("filename", outputFilename,
                           "doubleCheck", true,
                           "format", format);
-        output->input("pool").set(pool);
-        output->compute();
     }
+    output->input("pool").set(pool);
+    output->compute();
 }
 
-vector<float> getResult(Pool &pool, const string &name)
+void outputToFile(Pool &pool, const string &outputFilename, const AnalysisOptions &options)
 {
+    if (!outputFilename.empty())
+    {
+        prepareOutput(pool, options);
+        writeOutput(pool, outputFilename, options.outputFormat);
+    }
+}
 
-    vector<float> ts_vec;
-
-    if (pool.contains<vector<vector<Real>>>(name))
+size_t copyResult(const Pool &pool, const string &name, float *buffer, size_t capacity)
+{
+    // the values are copied from the pool maps, without copying the
+    // descriptor out of the pool first
+    size_t size = 0;
+    auto append = [&](const Real *values, size_t count)
     {
-        vector<vector<Real>> val = pool.value<vector<vector<Real>>>(name);
-        for (size_t i = 0; i < val.size(); ++i)
+        if (buffer && size < capacity)
         {
-            vector<Real> subVal = val[i];
-            for (size_t j = 0; j < subVal.size(); ++j)
-            {
-                ts_vec.push_back(subVal[j]);
-            }
+            copy_n(values, min(count, capacity - size), buffer + size);
         }
+        size += count;
+    };
+
+    auto rows = pool.getVectorRealPool().find(name);
+    if (rows != pool.getVectorRealPool().end())
+    {
+        for (const vector<Real> &row : rows->second) append(row.data(), row.size());
+        return size;
     }
-    else if (pool.contains<vector<Real>>(name))
+
+    auto frames = pool.getRealPool().find(name);
+    if (frames != pool.getRealPool().end())
     {
-        vector<Real> val = pool.value<vector<Real>>(name);
+        append(frames->second.data(), frames->second.size());
+        return size;
+    }
 
-        for (size_t i = 0; i < val.size(); ++i)
-        {
-            ts_vec.push_back(val[i]);
-        }
+    auto values = pool.getSingleVectorRealPool().find(name);
+    if (values != pool.getSingleVectorRealPool().end())
+    {
+        append(values->second.data(), values->second.size());
+        return size;
     }
-    else if (pool.contains<Real>(name))
+
+    auto single = pool.getSingleRealPool().find(name);
+    if (single != pool.getSingleRealPool().end())
     {
-        Real val = pool.value<Real>(name);
-        ts_vec.push_back(val);
+        append(&single->second, 1);
     }
-    return ts_vec;
+    return size;
+}
+
+vector<float> getResult(const Pool &pool, const string &name)
+{
+    vector<float> result(copyResult(pool, name, nullptr, 0));
+    copyResult(pool, name, result.data(), result.size());
+    return result;
 }
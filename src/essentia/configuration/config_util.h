@@ -24,6 +24,8 @@
 #define STREAMING_EXTRACTOR_METADATA_H
 
 #include "essentia_wrapper.h"
+#include "analysis_options.h"
+#include "../standard/FrameStatistics.h"
 
 #include <algorithmfactory.h>
 #include <pool.h>
@@ -37,14 +39,29 @@ using namespace essentia::streaming;
 using namespace essentia::scheduler;
 
 void setDefaultOptions(Pool &pool);
-void mergeOptionsAndResults(Pool &results, const Pool &options);
+void mergeOptionsAndResults(Pool &results, const AnalysisOptions &options);
 void pcmMetadata(AlgorithmFactory &factory, Pool &pool);
 void readMetadata(Pool &pool);
 
-essentia::Pool computeAggregation(Pool &pool, const Pool &options, int segments = 0);
-void cleanUp(Pool &pool, const Pool &options);
-void outputToFile(Pool &pool, const string &outputFilename, const Pool &options);
+essentia::Pool computeAggregation(Pool &pool, const AnalysisOptions &options, int segments = 0,
+                                  const essentiawrapper::DescriptorStatistics *frameStats = nullptr);
+void cleanUp(Pool &pool, const AnalysisOptions &options);
+void outputToFile(Pool &pool, const string &outputFilename, const AnalysisOptions &options);
 
-vector<float> getResult(Pool &pool, const string &name);
+// the two steps of outputToFile: the pool is final after prepareOutput, and
+// writeOutput only reads it
+void prepareOutput(Pool &pool, const AnalysisOptions &options);
+void writeOutput(const Pool &pool, const string &outputFilename, const string &format);
+
+/**
+ * @brief Copies the values of a real descriptor, row after row, to @e buffer.
+ *
+ * Called with a nullptr buffer, it only returns the size to allocate.
+ *
+ * @return The number of values of the descriptor, at most @e capacity of
+ * them are copied.
+ */
+size_t copyResult(const Pool &pool, const string &name, float *buffer, size_t capacity);
+vector<float> getResult(const Pool &pool, const string &name);
 
 #endif // STREAMING_EXTRACTOR_METADATA_H
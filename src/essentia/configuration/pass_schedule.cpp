@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "pass_schedule.h"
+
+#include "analysis_options.h"
+
+#include <algorithm>
+
+namespace {
+
+enum AudioSource
+{
+    SourceFile,     // decoded file: replay gain normalized mono, trimmed stereo
+    SourcePeaks,    // tonal spectral peaks recorded by the low level pass
+    SourceNone      // no audio, only the pool
+};
+
+const AudioSource passSource[PassCount] =
+{
+    SourceFile,     // PassLowLevel
+    SourcePeaks,    // PassTonal
+    SourceFile,     // PassMidLevel
+    SourceNone      // PassHighLevel
+};
+
+const AnalysisStage none = StageCount;
+
+struct StageNode
+{
+    AnalysisStage stage;
+    AudioSource source;
+    AnalysisStage streamedFrom; // connected to the outputs of this stage, same pass
+    AnalysisStage reads;        // reads the results of this stage from the pool, later pass
+};
+
+// in the order of AnalysisStage, a stage only depends on stages above it
+const StageNode stageGraph[StageCount] =
+{
+    { StageLowLevelSpectral,       SourceFile,     none,        none },
+    { StageLowLevelSpectralEqLoud, SourceFile,     none,        none },
+    { StageLevel,                  SourceFile,     none,        none },
+    { StageTuningFrequency,        SourceFile,     none,        none },
+    { StageRhythm,                 SourceFile,     none,        none },
+    { StageBpmHistogram,           SourceFile,     StageRhythm, none },
+    { StageOnset,                  SourceFile,     none,        none },
+    { StageDanceability,           SourceFile,     none,        none },
+    { StageTonalDescriptors,       SourcePeaks,    none,        StageTuningFrequency },
+    { StageBeatsLoudness,          SourceFile,     none,        StageRhythm },
+    { StagePanning,                SourceFile,     none,        none },
+    { StageFades,                  SourceFile,     none,        none },
+    { StageSegmentation,           SourceNone,     none,        StageLowLevelSpectral },
+    { StageSfx,                    SourceNone,     none,        StageLowLevelSpectral }
+};
+
+struct DescriptorNode
+{
+    bool DescriptorOptions::*requested;
+    AnalysisStage stages[2];
+};
+
+// the <name>.compute switches and the stages writing their descriptors
+const DescriptorNode descriptorGraph[] =
+{
+    { &DescriptorOptions::lowlevel,        { StageLowLevelSpectral, StageLowLevelSpectralEqLoud } },
+    { &DescriptorOptions::averageLoudness, { StageLevel,            none } },
+    { &DescriptorOptions::beats,           { StageRhythm,           none } },
+    { &DescriptorOptions::beatsLoudness,   { StageBeatsLoudness,    none } },
+    { &DescriptorOptions::bpmHistogram,    { StageBpmHistogram,     none } },
+    { &DescriptorOptions::onset,           { StageOnset,            none } },
+    { &DescriptorOptions::danceability,    { StageDanceability,     none } },
+    { &DescriptorOptions::tonal,           { StageTonalDescriptors, none } },
+    { &DescriptorOptions::sfx,             { StageSfx,              none } },
+    { &DescriptorOptions::panning,         { StagePanning,          none } },
+    { &DescriptorOptions::fades,           { StageFades,            none } }
+};
+
+} // namespace
+
+PassSchedule::PassSchedule()
+{
+    std::fill(_stages, _stages + StageCount, false);
+    std::fill(_passes, _passes + PassCount, false);
+    std::fill(_passOf, _passOf + StageCount, PassHighLevel);
+}
+
+void PassSchedule::plan(const DescriptorOptions &requested, bool segmentation)
+{
+    std::fill(_stages, _stages + StageCount, false);
+    std::fill(_passes, _passes + PassCount, false);
+
+    for (const DescriptorNode &desc : descriptorGraph)
+    {
+        if (!(requested.*desc.requested)) continue;
+
+        for (AnalysisStage stage : desc.stages)
+        {
+            if (stage != none) require(stage);
+        }
+    }
+
+    if (segmentation) require(StageSegmentation);
+
+    // the graph is ordered, so the passes of the dependencies are known
+    for (int i = 0; i < StageCount; ++i)
+    {
+        const StageNode &node = stageGraph[i];
+        if (!_stages[node.stage]) continue;
+
+        int earliest = 0;
+        if (node.streamedFrom != none) earliest = std::max(earliest, int(_passOf[node.streamedFrom]));
+        if (node.reads != none)        earliest = std::max(earliest, int(_passOf[node.reads]) + 1);
+
+        int pass = earliest;
+        while (pass < PassCount && passSource[pass] != node.source) ++pass;
+
+        if (pass == PassCount)
+        {
+            throw EssentiaException("PassSchedule: no pass can run stage ", i);
+        }
+
+        _passOf[node.stage] = AnalysisPass(pass);
+        _passes[pass] = true;
+    }
+}
+
+void PassSchedule::require(AnalysisStage stage)
+{
+    if (_stages[stage]) return;
+
+    _stages[stage] = true;
+
+    const StageNode &node = stageGraph[stage];
+    if (node.streamedFrom != none) require(node.streamedFrom);
+    if (node.reads != none) require(node.reads);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef PASS_SCHEDULE_H
+#define PASS_SCHEDULE_H
+
+struct DescriptorOptions;
+
+// the extractor stages, every stage is a group of algorithms writing one set
+// of descriptors
+enum AnalysisStage
+{
+    StageLowLevelSpectral,
+    StageLowLevelSpectralEqLoud,
+    StageLevel,
+    StageTuningFrequency,
+    StageRhythm,
+    StageBpmHistogram,
+    StageOnset,
+    StageDanceability,
+    StageTonalDescriptors,
+    StageBeatsLoudness,
+    StagePanning,
+    StageFades,
+    StageSegmentation,
+    StageSfx,
+    StageCount
+};
+
+// the passes over the audio, in the order they run
+enum AnalysisPass
+{
+    PassLowLevel,
+    PassTonal,      // no audio, works on the spectral peaks of the low level pass
+    PassMidLevel,
+    PassHighLevel,  // no audio, works on the results of the other passes
+    PassCount
+};
+
+/**
+ * @brief The PassSchedule class decides which stages and passes run for the
+ * requested descriptors.
+ *
+ * The descriptors, the stages producing them and the passes the stages run in
+ * are declared as a dependency graph. Only the stages reachable from the
+ * requested descriptors are scheduled, and each one is placed in the first
+ * pass over its audio source that runs after the results it reads are in the
+ * pool, so stages sharing a source share a pass.
+ */
+class PassSchedule
+{
+public:
+    PassSchedule();
+
+    /**
+     * @brief Schedules the stages needed for the requested descriptors.
+     * @param segmentation true if the segments are computed from this scope
+     */
+    void plan(const DescriptorOptions &requested, bool segmentation);
+
+    bool runs(AnalysisStage stage) const { return _stages[stage]; }
+    bool runs(AnalysisPass pass) const { return _passes[pass]; }
+
+    AnalysisPass passOf(AnalysisStage stage) const { return _passOf[stage]; }
+
+private:
+    void require(AnalysisStage stage);
+
+    bool _stages[StageCount];
+    bool _passes[PassCount];
+    AnalysisPass _passOf[StageCount];
+};
+
+#endif // PASS_SCHEDULE_H
@@ -25,8 +25,10 @@
 #include "algorithmfactory.h"
 #include "essentiamath.h"
 #include "streaming/algorithms/poolstorage.h"
+#include "../standard/StreamFrameStatistics.h"
 
-void LowLevelSpectral(SourceBase &input, Pool &pool, const Pool &options, const string &nspace)
+void LowLevelSpectral(SourceBase &input, SpectralFrontEnd &frontEnd, Pool &pool, DescriptorStatistics *stats, FrameStore *frameStore,
+                      const AnalysisOptions &options, const string &nspace)
 {
 
     streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
@@ -37,182 +39,249 @@ void LowLevelSpectral(SourceBase &input, Pool &pool, const Pool &options, const
     string sfxspace = "sfx.";
     if (!nspace.empty()) sfxspace = nspace + ".sfx.";
 
-    Real sampleRate = options.value<Real>("analysisSampleRate");
-    int frameSize =   int(options.value<Real>("lowlevel.frameSize"));
-    int hopSize =     int(options.value<Real>("lowlevel.hopSize"));
-    int zeroPadding = int(options.value<Real>("lowlevel.zeroPadding"));
-    string silentFrames = options.value<string>("lowlevel.silentFrames");
-    string windowType = options.value<string>("lowlevel.windowType");
+    Real sampleRate = options.analysisSampleRate;
+    int frameSize =   options.lowlevel.frameSize;
+    Real framePeriod = options.lowlevel.hopSize / sampleRate;
 
-    // FrameCutter
-    Algorithm *fc = factory.create("FrameCutter",
-                                   "frameSize", frameSize,
-                                   "hopSize", hopSize,
-                                   "silentFrames", silentFrames);
-    connect(input, fc->input("signal"));
+    // only the requested descriptors and the ones other stages depend on
+    const SpectralDescriptors &desc = options.spectral(nspace);
 
-    // Silence Rate
-    Real thresholds_dB[] = { -20, -30, -60 };
+    bool needBarkBands = desc.barkBands || desc.spectralCrest ||
+                         desc.spectralFlatnessDb || desc.barkBandsMoments;
+    bool needSpectrum  = desc.mfcc || desc.spectralDecrease || desc.spectralEnergy ||
+                         desc.spectralEnergyBands || desc.hfc || desc.frequencyBands ||
+                         desc.spectralRms || desc.spectralFlux || desc.spectralRolloff ||
+                         desc.spectralStrongPeak || needBarkBands || desc.spectralComplexity ||
+                         desc.pitch || desc.pitchSalience;
 
-    vector<Real> thresholds(ARRAY_SIZE(thresholds_dB));
-    for (uint i = 0; i < thresholds.size(); i++)
+    if (!needSpectrum && !desc.silenceRate && !desc.zeroCrossingRate)
     {
-        thresholds[i] = db2lin(thresholds_dB[i] / 2.0);
+        return;
     }
 
-    Algorithm *sr = factory.create("SilenceRate",
-                                   "thresholds", thresholds);
-    connect(fc->output("frame"), sr->input("frame"));
-    connect(sr->output("threshold_0"), pool, llspace + "silence_rate_20dB");
-    connect(sr->output("threshold_1"), pool, llspace + "silence_rate_30dB");
-    connect(sr->output("threshold_2"), pool, llspace + "silence_rate_60dB");
+    // FrameCutter, shared with the other extractors on this source
+    SourceBase &frames = frontEnd.frames(input, options.lowlevel);
 
-    // Windowing
-    Algorithm *w = factory.create("Windowing",
-                                  "type", windowType,
-                                  "zeroPadding", zeroPadding);
-    connect(fc->output("frame"), w->input("frame"));
+    // Silence Rate
+    if (desc.silenceRate)
+    {
+        Real thresholds_dB[] = { -20, -30, -60 };
 
-    // Spectrum
-    Algorithm *spec = factory.create("Spectrum");
-    connect(w->output("frame"), spec->input("frame"));
+        vector<Real> thresholds(ARRAY_SIZE(thresholds_dB));
+        for (uint i = 0; i < thresholds.size(); i++)
+        {
+            thresholds[i] = db2lin(thresholds_dB[i] / 2.0);
+        }
+
+        Algorithm *sr = factory.create("SilenceRate",
+                                       "thresholds", thresholds);
+        connect(frames, sr->input("frame"));
+        essentiawrapper::connectDescriptor(sr->output("threshold_0"), stats, frameStore, pool, llspace + "silence_rate_20dB", framePeriod);
+        essentiawrapper::connectDescriptor(sr->output("threshold_1"), stats, frameStore, pool, llspace + "silence_rate_30dB", framePeriod);
+        essentiawrapper::connectDescriptor(sr->output("threshold_2"), stats, frameStore, pool, llspace + "silence_rate_60dB", framePeriod);
+    }
 
     // Temporal Descriptors
-    Algorithm *zcr = factory.create("ZeroCrossingRate");
-    connect(zcr->input("signal"), fc->output("frame"));
-    connect(zcr->output("zeroCrossingRate"), pool, llspace + "zerocrossingrate");
+    if (desc.zeroCrossingRate)
+    {
+        Algorithm *zcr = factory.create("ZeroCrossingRate");
+        connect(zcr->input("signal"), frames);
+        essentiawrapper::connectDescriptor(zcr->output("zeroCrossingRate"), stats, frameStore, pool, llspace + "zerocrossingrate", framePeriod);
+    }
 
+    if (!needSpectrum)
+    {
+        return;
+    }
+
+    // Windowing and Spectrum
+    SourceBase &spectrum = frontEnd.spectrum(input, options.lowlevel);
 
     // MFCC
-    Algorithm *mfcc = factory.create("MFCC");
-    connect(spec->output("spectrum"), mfcc->input("spectrum"));
-    connect(mfcc->output("bands"), NOWHERE);
-    connect(mfcc->output("mfcc"), pool, llspace + "mfcc");
+    if (desc.mfcc)
+    {
+        Algorithm *mfcc = factory.create("MFCC");
+        connect(spectrum, mfcc->input("spectrum"));
+        connect(mfcc->output("bands"), NOWHERE);
+        // the segmentation needs the frames
+        DescriptorStatistics *mfccStats = options.segmentation.compute ? nullptr : stats;
+        essentiawrapper::connectDescriptor(mfcc->output("mfcc"), mfccStats, frameStore, pool, llspace + "mfcc", framePeriod);
+    }
 
     // Spectral Decrease
-    Algorithm *square = factory.create("UnaryOperator", "type", "square");
-    Algorithm *decrease = factory.create("Decrease",
-                                         "range", sampleRate * 0.5);
-    connect(spec->output("spectrum"), square->input("array"));
-    connect(square->output("array"), decrease->input("array"));
-    connect(decrease->output("decrease"), pool, llspace + "spectral_decrease");
+    if (desc.spectralDecrease)
+    {
+        Algorithm *square = factory.create("UnaryOperator", "type", "square");
+        Algorithm *decrease = factory.create("Decrease",
+                                             "range", sampleRate * 0.5);
+        connect(spectrum, square->input("array"));
+        connect(square->output("array"), decrease->input("array"));
+        essentiawrapper::connectDescriptor(decrease->output("decrease"), stats, frameStore, pool, llspace + "spectral_decrease", framePeriod);
+    }
 
     // Spectral Energy
-    Algorithm *energy = factory.create("Energy");
-    connect(spec->output("spectrum"), energy->input("array"));
-    connect(energy->output("energy"), pool, llspace + "spectral_energy");
+    if (desc.spectralEnergy)
+    {
+        Algorithm *energy = factory.create("Energy");
+        connect(spectrum, energy->input("array"));
+        essentiawrapper::connectDescriptor(energy->output("energy"), stats, frameStore, pool, llspace + "spectral_energy", framePeriod);
+    }
 
     // Spectral Energy Band Ratio
-    Algorithm *ebr_low = factory.create("EnergyBand",
-                                        "startCutoffFrequency", 20.0,
-                                        "stopCutoffFrequency", 150.0);
-    connect(spec->output("spectrum"), ebr_low->input("spectrum"));
-    connect(ebr_low->output("energyBand"), pool, llspace + "spectral_energyband_low");
-
-    Algorithm *ebr_mid_low = factory.create("EnergyBand",
-                                            "startCutoffFrequency", 150.0,
-                                            "stopCutoffFrequency", 800.0);
-    connect(spec->output("spectrum"), ebr_mid_low->input("spectrum"));
-    connect(ebr_mid_low->output("energyBand"), pool, llspace + "spectral_energyband_middle_low");
-
-    Algorithm *ebr_mid_hi = factory.create("EnergyBand",
-                                           "startCutoffFrequency", 800.0,
-                                           "stopCutoffFrequency", 4000.0);
-    connect(spec->output("spectrum"), ebr_mid_hi->input("spectrum"));
-    connect(ebr_mid_hi->output("energyBand"), pool, llspace + "spectral_energyband_middle_high");
-
-
-    Algorithm *ebr_hi = factory.create("EnergyBand",
-                                       "startCutoffFrequency", 4000.0,
-                                       "stopCutoffFrequency", 20000.0);
-    connect(spec->output("spectrum"), ebr_hi->input("spectrum"));
-    connect(ebr_hi->output("energyBand"), pool, llspace + "spectral_energyband_high");
+    if (desc.spectralEnergyBands)
+    {
+        Algorithm *ebr_low = factory.create("EnergyBand",
+                                            "startCutoffFrequency", 20.0,
+                                            "stopCutoffFrequency", 150.0);
+        connect(spectrum, ebr_low->input("spectrum"));
+        essentiawrapper::connectDescriptor(ebr_low->output("energyBand"), stats, frameStore, pool, llspace + "spectral_energyband_low", framePeriod);
+
+        Algorithm *ebr_mid_low = factory.create("EnergyBand",
+                                                "startCutoffFrequency", 150.0,
+                                                "stopCutoffFrequency", 800.0);
+        connect(spectrum, ebr_mid_low->input("spectrum"));
+        essentiawrapper::connectDescriptor(ebr_mid_low->output("energyBand"), stats, frameStore, pool, llspace + "spectral_energyband_middle_low", framePeriod);
+
+        Algorithm *ebr_mid_hi = factory.create("EnergyBand",
+                                               "startCutoffFrequency", 800.0,
+                                               "stopCutoffFrequency", 4000.0);
+        connect(spectrum, ebr_mid_hi->input("spectrum"));
+        essentiawrapper::connectDescriptor(ebr_mid_hi->output("energyBand"), stats, frameStore, pool, llspace + "spectral_energyband_middle_high", framePeriod);
+
+
+        Algorithm *ebr_hi = factory.create("EnergyBand",
+                                           "startCutoffFrequency", 4000.0,
+                                           "stopCutoffFrequency", 20000.0);
+        connect(spectrum, ebr_hi->input("spectrum"));
+        essentiawrapper::connectDescriptor(ebr_hi->output("energyBand"), stats, frameStore, pool, llspace + "spectral_energyband_high", framePeriod);
+    }
 
     // Spectral HFC
-    Algorithm *hfc = factory.create("HFC");
-    connect(spec->output("spectrum"), hfc->input("spectrum"));
-    connect(hfc->output("hfc"), pool, llspace + "hfc");
+    if (desc.hfc)
+    {
+        Algorithm *hfc = factory.create("HFC");
+        connect(spectrum, hfc->input("spectrum"));
+        essentiawrapper::connectDescriptor(hfc->output("hfc"), stats, frameStore, pool, llspace + "hfc", framePeriod);
+    }
 
     // Spectral Frequency Bands
-    Algorithm *fb = factory.create("FrequencyBands",
-                                   "sampleRate", sampleRate);
-    connect(spec->output("spectrum"), fb->input("spectrum"));
-    connect(fb->output("bands"), pool, llspace + "frequency_bands");
+    if (desc.frequencyBands)
+    {
+        Algorithm *fb = factory.create("FrequencyBands",
+                                       "sampleRate", sampleRate);
+        connect(spectrum, fb->input("spectrum"));
+        essentiawrapper::connectDescriptor(fb->output("bands"), stats, frameStore, pool, llspace + "frequency_bands", framePeriod);
+    }
 
     // Spectral RMS
-    Algorithm *rms = factory.create("RMS");
-    connect(spec->output("spectrum"), rms->input("array"));
-    connect(rms->output("rms"), pool, llspace + "spectral_rms");
+    if (desc.spectralRms)
+    {
+        Algorithm *rms = factory.create("RMS");
+        connect(spectrum, rms->input("array"));
+        essentiawrapper::connectDescriptor(rms->output("rms"), stats, frameStore, pool, llspace + "spectral_rms", framePeriod);
+    }
 
     // Spectral Flux
-    Algorithm *flux = factory.create("Flux");
-    connect(spec->output("spectrum"), flux->input("spectrum"));
-    connect(flux->output("flux"), pool, llspace + "spectral_flux");
+    if (desc.spectralFlux)
+    {
+        Algorithm *flux = factory.create("Flux");
+        connect(spectrum, flux->input("spectrum"));
+        essentiawrapper::connectDescriptor(flux->output("flux"), stats, frameStore, pool, llspace + "spectral_flux", framePeriod);
+    }
 
     // Spectral Roll Off
-    Algorithm *ro = factory.create("RollOff");
-    connect(spec->output("spectrum"), ro->input("spectrum"));
-    connect(ro->output("rollOff"), pool, llspace + "spectral_rolloff");
+    if (desc.spectralRolloff)
+    {
+        Algorithm *ro = factory.create("RollOff");
+        connect(spectrum, ro->input("spectrum"));
+        essentiawrapper::connectDescriptor(ro->output("rollOff"), stats, frameStore, pool, llspace + "spectral_rolloff", framePeriod);
+    }
 
     // Spectral Strong Peak
-    Algorithm *sp = factory.create("StrongPeak");
-    connect(spec->output("spectrum"), sp->input("spectrum"));
-    connect(sp->output("strongPeak"), pool, llspace + "spectral_strongpeak");
+    if (desc.spectralStrongPeak)
+    {
+        Algorithm *sp = factory.create("StrongPeak");
+        connect(spectrum, sp->input("spectrum"));
+        essentiawrapper::connectDescriptor(sp->output("strongPeak"), stats, frameStore, pool, llspace + "spectral_strongpeak", framePeriod);
+    }
 
     // BarkBands
-    uint nBarkBands = 27;
-    Algorithm *barkBands = factory.create("BarkBands",
-                                          "numberBands", nBarkBands);
-    connect(spec->output("spectrum"), barkBands->input("spectrum"));
-    connect(barkBands->output("bands"), pool, llspace + "barkbands");
-
-    // Spectral Crest
-    Algorithm *crest = factory.create("Crest");
-    connect(barkBands->output("bands"), crest->input("array"));
-    connect(crest->output("crest"), pool, llspace + "spectral_crest");
-
-    // Spectral Flatness DB
-    Algorithm *flatness = factory.create("FlatnessDB");
-    connect(barkBands->output("bands"), flatness->input("array"));
-    connect(flatness->output("flatnessDB"), pool, llspace + "spectral_flatness_db");
-
-    // Spectral BarkBands Central Moments Statistics
-    Algorithm *cm = factory.create("CentralMoments",
-                                   "range", nBarkBands - 1);
-    Algorithm *ds = factory.create("DistributionShape");
-    connect(barkBands->output("bands"), cm->input("array"));
-    connect(cm->output("centralMoments"), ds->input("centralMoments"));
-    connect(ds->output("kurtosis"), pool, llspace + "barkbands_kurtosis");
-    connect(ds->output("spread"), pool, llspace + "barkbands_spread");
-    connect(ds->output("skewness"), pool, llspace + "barkbands_skewness");
+    if (needBarkBands)
+    {
+        uint nBarkBands = 27;
+        Algorithm *barkBands = factory.create("BarkBands",
+                                              "numberBands", nBarkBands);
+        connect(spectrum, barkBands->input("spectrum"));
+        if (desc.barkBands)
+            essentiawrapper::connectDescriptor(barkBands->output("bands"), stats, frameStore, pool, llspace + "barkbands", framePeriod);
+
+        // Spectral Crest
+        if (desc.spectralCrest)
+        {
+            Algorithm *crest = factory.create("Crest");
+            connect(barkBands->output("bands"), crest->input("array"));
+            essentiawrapper::connectDescriptor(crest->output("crest"), stats, frameStore, pool, llspace + "spectral_crest", framePeriod);
+        }
+
+        // Spectral Flatness DB
+        if (desc.spectralFlatnessDb)
+        {
+            Algorithm *flatness = factory.create("FlatnessDB");
+            connect(barkBands->output("bands"), flatness->input("array"));
+            essentiawrapper::connectDescriptor(flatness->output("flatnessDB"), stats, frameStore, pool, llspace + "spectral_flatness_db", framePeriod);
+        }
+
+        // Spectral BarkBands Central Moments Statistics
+        if (desc.barkBandsMoments)
+        {
+            Algorithm *cm = factory.create("CentralMoments",
+                                           "range", nBarkBands - 1);
+            Algorithm *ds = factory.create("DistributionShape");
+            connect(barkBands->output("bands"), cm->input("array"));
+            connect(cm->output("centralMoments"), ds->input("centralMoments"));
+            essentiawrapper::connectDescriptor(ds->output("kurtosis"), stats, frameStore, pool, llspace + "barkbands_kurtosis", framePeriod);
+            essentiawrapper::connectDescriptor(ds->output("spread"), stats, frameStore, pool, llspace + "barkbands_spread", framePeriod);
+            essentiawrapper::connectDescriptor(ds->output("skewness"), stats, frameStore, pool, llspace + "barkbands_skewness", framePeriod);
+        }
+    }
 
     // Spectral Complexity
-    Algorithm *tc = factory.create("SpectralComplexity",
-                                   "magnitudeThreshold", 0.005);
-    connect(spec->output("spectrum"), tc->input("spectrum"));
-    connect(tc->output("spectralComplexity"), pool, llspace + "spectral_complexity");
+    if (desc.spectralComplexity)
+    {
+        Algorithm *tc = factory.create("SpectralComplexity",
+                                       "magnitudeThreshold", 0.005);
+        connect(spectrum, tc->input("spectrum"));
+        essentiawrapper::connectDescriptor(tc->output("spectralComplexity"), stats, frameStore, pool, llspace + "spectral_complexity", framePeriod);
+    }
+
+    // Pitch Salience
+    if (desc.pitchSalience)
+    {
+        Algorithm *ps = factory.create("PitchSalience");
+        connect(spectrum, ps->input("spectrum"));
+        essentiawrapper::connectDescriptor(ps->output("pitchSalience"), stats, frameStore, pool, llspace + "pitch_salience", framePeriod);
+    }
+
+    if (!desc.pitch)
+    {
+        return;
+    }
 
     // Pitch Detection
     Algorithm *pitch = factory.create("PitchYinFFT",
                                       "frameSize", frameSize);
-    connect(spec->output("spectrum"), pitch->input("spectrum"));
+    connect(spectrum, pitch->input("spectrum"));
     connect(pitch->output("pitch"), pool, llspace + "pitch");
-    connect(pitch->output("pitchConfidence"), pool, llspace + "pitch_instantaneous_confidence");
-
-    // Pitch Salience
-    Algorithm *ps = factory.create("PitchSalience");
-    connect(spec->output("spectrum"), ps->input("spectrum"));
-    connect(ps->output("pitchSalience"), pool, llspace + "pitch_salience");
-
-    // Harmonic Peaks
-    Algorithm *peaks = factory.create("SpectralPeaks",
-                                      "minFrequency", sampleRate / Real(frameSize),
-                                      "orderBy", "frequency");
+    essentiawrapper::connectDescriptor(pitch->output("pitchConfidence"), stats, frameStore, pool, llspace + "pitch_instantaneous_confidence", framePeriod);
 
-    if (options.value<Real>("sfx.compute") != 0)
+    // Harmonic Peaks, the pitch is always computed for sfx
+    if (options.track.sfx)
     {
+        Algorithm *peaks = factory.create("SpectralPeaks",
+                                          "minFrequency", sampleRate / Real(frameSize),
+                                          "orderBy", "frequency");
         Algorithm *harmPeaks = factory.create("HarmonicPeaks");
-        connect(spec->output("spectrum"), peaks->input("spectrum"));
+        connect(spectrum, peaks->input("spectrum"));
         connect(peaks->output("frequencies"), harmPeaks->input("frequencies"));
         connect(peaks->output("magnitudes"), harmPeaks->input("magnitudes"));
         connect(pitch->output("pitch"), harmPeaks->input("pitch"));
@@ -236,66 +305,50 @@ void LowLevelSpectral(SourceBase &input, Pool &pool, const Pool &options, const
 
 
 // expects the audio source to already be equal-loudness filtered
-void LowLevelSpectralEqLoud(SourceBase &input, Pool &pool, const Pool &options, const string &nspace)
+void LowLevelSpectralEqLoud(SourceBase &input, SpectralFrontEnd &frontEnd, Pool &pool, DescriptorStatistics *stats, FrameStore *frameStore,
+                            const AnalysisOptions &options, const string &nspace)
 {
 
     // namespaces:
     string llspace = "lowlevel.";
     if (!nspace.empty()) llspace = nspace + ".lowlevel.";
 
-    Real sampleRate = options.value<Real>("analysisSampleRate");
-    int frameSize =   int(options.value<Real>("lowlevel.frameSize"));
-    int hopSize =     int(options.value<Real>("lowlevel.hopSize"));
-    int zeroPadding = int(options.value<Real>("lowlevel.zeroPadding"));
-    string silentFrames = options.value<string>("lowlevel.silentFrames");
-    string windowType = options.value<string>("lowlevel.windowType");
-
+    Real sampleRate = options.analysisSampleRate;
+    int frameSize =   options.lowlevel.frameSize;
+    Real framePeriod = options.lowlevel.hopSize / sampleRate;
 
     streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
 
-    // FrameCutter
-    Algorithm *fc = factory.create("FrameCutter",
-                                   "frameSize", frameSize,
-                                   "hopSize", hopSize,
-                                   "silentFrames", silentFrames);
-    connect(input, fc->input("signal"));
-
-    // Window
-    Algorithm *w = factory.create("Windowing",
-                                  "type", windowType,
-                                  "zeroPadding", zeroPadding);
-    connect(fc->output("frame"), w->input("frame"));
-
-    // Spectrum
-    Algorithm *spec = factory.create("Spectrum");
-    connect(w->output("frame"), spec->input("frame"));
+    // FrameCutter, Window and Spectrum, shared with LowLevelSpectral if it
+    // runs on the same source
+    SourceBase &spectrum = frontEnd.spectrum(input, options.lowlevel);
 
     // Spectral Centroid
     Algorithm *square = factory.create("UnaryOperator", "type", "square");
     Algorithm *centroid = factory.create("Centroid",
                                          "range", sampleRate * 0.5);
-    connect(spec->output("spectrum"), square->input("array"));
+    connect(spectrum, square->input("array"));
     connect(square->output("array"), centroid->input("array"));
-    connect(centroid->output("centroid"), pool, llspace + "spectral_centroid");
+    essentiawrapper::connectDescriptor(centroid->output("centroid"), stats, frameStore, pool, llspace + "spectral_centroid", framePeriod);
 
     // Spectral Central Moments Statistics
     Algorithm *cm = factory.create("CentralMoments",
                                    "range", sampleRate * 0.5);
     Algorithm *ds = factory.create("DistributionShape");
-    connect(spec->output("spectrum"), cm->input("array"));
+    connect(spectrum, cm->input("array"));
     connect(cm->output("centralMoments"), ds->input("centralMoments"));
-    connect(ds->output("kurtosis"), pool, llspace + "spectral_kurtosis");
-    connect(ds->output("spread"), pool, llspace + "spectral_spread");
-    connect(ds->output("skewness"), pool, llspace + "spectral_skewness");
+    essentiawrapper::connectDescriptor(ds->output("kurtosis"), stats, frameStore, pool, llspace + "spectral_kurtosis", framePeriod);
+    essentiawrapper::connectDescriptor(ds->output("spread"), stats, frameStore, pool, llspace + "spectral_spread", framePeriod);
+    essentiawrapper::connectDescriptor(ds->output("skewness"), stats, frameStore, pool, llspace + "spectral_skewness", framePeriod);
 
     // Spectral Dissonance
     Algorithm *peaks = factory.create("SpectralPeaks",
                                       "orderBy", "frequency");
     Algorithm *diss = factory.create("Dissonance");
-    connect(spec->output("spectrum"), peaks->input("spectrum"));
+    connect(spectrum, peaks->input("spectrum"));
     connect(peaks->output("frequencies"), diss->input("frequencies"));
     connect(peaks->output("magnitudes"), diss->input("magnitudes"));
-    connect(diss->output("dissonance"), pool, llspace + "dissonance");
+    essentiawrapper::connectDescriptor(diss->output("dissonance"), stats, frameStore, pool, llspace + "dissonance", framePeriod);
 
     // Spectral Contrast
     Algorithm *sc = factory.create("SpectralContrast",
@@ -307,13 +360,13 @@ void LowLevelSpectralEqLoud(SourceBase &input, Pool &pool, const Pool &options,
                                    "neighbourRatio", 0.4,
                                    "staticDistribution", 0.15);
 
-    connect(spec->output("spectrum"), sc->input("spectrum"));
-    connect(sc->output("spectralContrast"), pool, llspace + "sccoeffs");
-    connect(sc->output("spectralValley"), pool, llspace + "scvalleys");
+    connect(spectrum, sc->input("spectrum"));
+    essentiawrapper::connectDescriptor(sc->output("spectralContrast"), stats, frameStore, pool, llspace + "sccoeffs", framePeriod);
+    essentiawrapper::connectDescriptor(sc->output("spectralValley"), stats, frameStore, pool, llspace + "scvalleys", framePeriod);
 }
 
 // expects the audio source to already be equal-loudness filtered
-void Level(SourceBase &input, Pool &pool, const Pool &options, const string &nspace)
+void Level(SourceBase &input, Pool &pool, const AnalysisOptions &options, const string &nspace)
 {
 
     // namespace:
@@ -323,8 +376,8 @@ void Level(SourceBase &input, Pool &pool, const Pool &options, const string &nsp
     streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
 
     // FrameCutter
-    int frameSize = int(options.value<Real>("average_loudness.frameSize"));
-    int hopSize =   int(options.value<Real>("average_loudness.hopSize"));
+    int frameSize = options.averageLoudness.frameSize;
+    int hopSize =   options.averageLoudness.hopSize;
     Algorithm *fc = factory.create("FrameCutter",
                                    "frameSize", frameSize,
                                    "hopSize", hopSize,
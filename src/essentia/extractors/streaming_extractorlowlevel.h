@@ -26,14 +26,22 @@
 #include "streaming/sourcebase.h"
 #include "pool.h"
 #include "types.h"
+#include "../configuration/analysis_options.h"
+#include "streaming_spectralfrontend.h"
+#include "../standard/FrameStatistics.h"
+#include "../standard/FrameStore.h"
 
 using namespace std;
 using namespace essentia;
 using namespace essentia::streaming;
+using essentiawrapper::DescriptorStatistics;
+using essentiawrapper::FrameStore;
 
-void LowLevelSpectral(SourceBase &input, Pool &pool, const Pool &options, const string &nspace = "");
-void LowLevelSpectralEqLoud(SourceBase &input, Pool &pool, const Pool &options, const string &nspace = "");
-void Level(SourceBase &input, Pool &pool, const Pool &options, const string &nspace = "");
+void LowLevelSpectral(SourceBase &input, SpectralFrontEnd &frontEnd, Pool &pool, DescriptorStatistics *stats, FrameStore *frameStore,
+                      const AnalysisOptions &options, const string &nspace = "");
+void LowLevelSpectralEqLoud(SourceBase &input, SpectralFrontEnd &frontEnd, Pool &pool, DescriptorStatistics *stats, FrameStore *frameStore,
+                            const AnalysisOptions &options, const string &nspace = "");
+void Level(SourceBase &input, Pool &pool, const AnalysisOptions &options, const string &nspace = "");
 void LevelAverage(Pool &pool, const string &nspace = "");
 
 #endif // STREAMING_EXTRACTORLOWLEVEL_H
@@ -32,13 +32,11 @@ using namespace standard;
 // final release or during the 1.x cycle. However, the schema need to be
 // complete before that, so just put default values for these.
 // Also make sure that some descriptors that might have fucked up come out nice.
-void PostProcess(Pool &pool, const Pool &options, const string &nspace)
+void PostProcess(Pool &pool, const AnalysisOptions &options, const string &nspace)
 {
     cout << "PostProcess missing descriptors" << endl;
 
-    bool computeBeats = nspace.empty() ?
-                         options.value<Real>("rhythm.beats.compute") != 0 :
-                         options.value<Real>("segmentation.desc.rhythm.beats.compute") != 0;
+    bool computeBeats = options.compute(nspace).beats;
 
     if (computeBeats)
     {
@@ -49,7 +47,7 @@ void PostProcess(Pool &pool, const Pool &options, const string &nspace)
             pool.set(rhythmspace + "bpm_confidence", 0.0);
         if (find(descNames.begin(), descNames.end(), rhythmspace + "perceptual_tempo") == descNames.end())
             pool.set(rhythmspace + "perceptual_tempo", "unknown");
-        if (options.value<Real>("rhythm.beats.loudness.compute") != 0)
+        if (options.track.beatsLoudness)
         {
             if (find(descNames.begin(), descNames.end(), rhythmspace + "beats.loudness") == descNames.end())
                 pool.add(rhythmspace + "beats.loudness", Real(0.0));
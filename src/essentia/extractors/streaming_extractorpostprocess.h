@@ -26,11 +26,12 @@
 
 #include "pool.h"
 #include "types.h"
+#include "../configuration/analysis_options.h"
 #include <string>
 
 using namespace std;
 using namespace essentia;
 
-void PostProcess(Pool &pool, const Pool &options, const string &nspace = "");
+void PostProcess(Pool &pool, const AnalysisOptions &options, const string &nspace = "");
 
 #endif // STREAMING_EXTRACTOR_POSTPROCESS_H
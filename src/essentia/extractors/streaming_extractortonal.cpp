@@ -25,10 +25,37 @@
 #include "algorithmfactory.h"
 #include "essentiamath.h"
 #include "streaming/algorithms/poolstorage.h"
+#include "../standard/StreamFrameStatistics.h"
 
 #include <memory>
 
-void TuningSystemFeatures(Pool &pool, const string &nspace)
+namespace {
+
+// the mean of a descriptor the tonal pass only keeps the mean of
+vector<Real> tuningMean(const Pool &pool, const DescriptorMeans &tuningMeans, const string &name)
+{
+    essentiawrapper::DescriptorId id = essentiawrapper::DescriptorRegistry::instance().intern(name);
+    const essentiawrapper::FrameMean *mean = tuningMeans.find(pool, id);
+    if (!mean)
+    {
+        throw EssentiaException("TuningSystemFeatures: no frames of ", name);
+    }
+
+    return mean->mean();
+}
+
+void connectMean(SourceBase &source, DescriptorMeans &tuningMeans, const Pool &pool, const string &name)
+{
+    essentiawrapper::DescriptorId id = essentiawrapper::DescriptorRegistry::instance().intern(name);
+
+    Algorithm *mean = new essentiawrapper::StreamFrameMean(tuningMeans.add(pool, id));
+    mean->setName("mean_" + name);
+    connect(source, mean->input("data"));
+}
+
+} // namespace
+
+void TuningSystemFeatures(Pool &pool, const DescriptorMeans &tuningMeans, const string &nspace)
 {
 
     cout << "Tuning system features" << endl;
@@ -37,7 +64,7 @@ void TuningSystemFeatures(Pool &pool, const string &nspace)
     string tonalspace = "tonal.";
     if (!nspace.empty()) tonalspace = nspace + ".tonal.";
 
-    vector<Real> hpcp_highres = meanFrames(pool.value<vector<vector<Real> > >(tonalspace + "hpcp_highres"));
+    vector<Real> hpcp_highres = tuningMean(pool, tuningMeans, tonalspace + "hpcp_highres");
     normalize(hpcp_highres);
 
     // 1- diatonic strength
@@ -70,7 +97,7 @@ void TuningSystemFeatures(Pool &pool, const string &nspace)
     pool.set(tonalspace + "tuning_nontempered_energy_ratio", ntEnergy);
 
     // 3- THPCP
-    vector<Real> hpcp = meanFrames(pool.value<vector<vector<Real> > >(tonalspace + "hpcp"));
+    vector<Real> hpcp = tuningMean(pool, tuningMeans, tonalspace + "hpcp");
     normalize(hpcp);
     int idxMax = argmax(hpcp);
     vector<Real> hpcp_bak = hpcp;
@@ -88,37 +115,17 @@ void TuningSystemFeatures(Pool &pool, const string &nspace)
 
 }
 
-void TuningFrequency(SourceBase &input, Pool &pool, const Pool &options, const string &nspace)
+void TuningFrequency(SourceBase &input, SpectralFrontEnd &frontEnd, TonalPeaks *peaksStore, Pool &pool, const AnalysisOptions &options, const string &nspace)
 {
 
     // namespace
     string tonalspace = "tonal.";
     if (!nspace.empty()) tonalspace = nspace + ".tonal.";
 
-    int frameSize = int(options.value<Real>("tonal.frameSize"));
-    int hopSize =   int(options.value<Real>("tonal.hopSize"));
-    string silentFrames = options.value<string>("tonal.silentFrames");
-    string windowType = options.value<string>("tonal.windowType");
-    int zeroPadding = int(options.value<Real>("tonal.zeroPadding"));
-
     streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
 
-    // FrameCutter
-    Algorithm *fc = factory.create("FrameCutter",
-                                   "frameSize", frameSize,
-                                   "hopSize", hopSize,
-                                   "silentFrames", silentFrames);
-    connect(input, fc->input("signal"));
-
-    // Windowing
-    Algorithm *w = factory.create("Windowing",
-                                  "type", windowType,
-                                  "zeroPadding", zeroPadding);
-    connect(fc->output("frame"), w->input("frame"));
-
-    // Spectrum
-    Algorithm *spec = factory.create("Spectrum");
-    connect(w->output("frame"), spec->input("frame"));
+    // FrameCutter, Windowing and Spectrum
+    SourceBase &spectrum = frontEnd.spectrum(input, options.tonal);
 
     // Spectral Peaks
     Algorithm *peaks = factory.create("SpectralPeaks",
@@ -127,7 +134,7 @@ void TuningFrequency(SourceBase &input, Pool &pool, const Pool &options, const s
                                       "minFrequency", 40,
                                       "maxFrequency", 5000,
                                       "orderBy", "frequency");
-    connect(spec->output("spectrum"), peaks->input("spectrum"));
+    connect(spectrum, peaks->input("spectrum"));
 
     // Tuning Frequency
     Algorithm *tuning = factory.create("TuningFrequency");
@@ -136,91 +143,64 @@ void TuningFrequency(SourceBase &input, Pool &pool, const Pool &options, const s
     connect(tuning->output("tuningFrequency"), pool, tonalspace + "tuning_frequency");
     connect(tuning->output("tuningCents"), NOWHERE);
 
+    // keep the peaks for TonalDescriptors, which needs the final tuning
+    // frequency and runs on them after this pass
+    if (peaksStore)
+    {
+        Algorithm *writer = new essentiawrapper::StreamTonalPeaksWriter(peaksStore);
+        connect(peaks->output("frequencies"), writer->input("frequencies"));
+        connect(peaks->output("magnitudes"), writer->input("magnitudes"));
+    }
+
 }
 
-void TonalDescriptors(SourceBase &input, Pool &pool, const Pool &options, const string &nspace)
+void TonalDescriptors(SourceBase &frequencies, SourceBase &magnitudes, Pool &pool, DescriptorStatistics *stats, DescriptorMeans &tuningMeans,
+                      const AnalysisOptions &options, const string &nspace)
 {
 
     // namespace
     string tonalspace = "tonal.";
     if (!nspace.empty()) tonalspace = nspace + ".tonal.";
 
-    int frameSize = int(options.value<Real>("tonal.frameSize"));
-    int hopSize =   int(options.value<Real>("tonal.hopSize"));
-    string silentFrames = options.value<string>("tonal.silentFrames");
-    string windowType = options.value<string>("tonal.windowType");
-    int zeroPadding = int(options.value<Real>("tonal.zeroPadding"));
-
     streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
 
-    // FrameCutter
-    Algorithm *fc = factory.create("FrameCutter",
-                                   "frameSize", frameSize,
-                                   "hopSize", hopSize,
-                                   "silentFrames", silentFrames);
-    connect(input, fc->input("signal"));
-
-    // Windowing
-    Algorithm *w = factory.create("Windowing",
-                                  "type", windowType,
-                                  "zeroPadding", zeroPadding);
-    connect(fc->output("frame"), w->input("frame"));
-
-    // Spectrum
-    Algorithm *spec = factory.create("Spectrum");
-    connect(w->output("frame"), spec->input("frame"));
-
-    // Spectral Peaks
-    Algorithm *peaks = factory.create("SpectralPeaks",
-                                      "maxPeaks", 10000,
-                                      "magnitudeThreshold", 0.00001,
-                                      "minFrequency", 40,
-                                      "maxFrequency", 5000,
-                                      "orderBy", "magnitude");
-    connect(spec->output("spectrum"), peaks->input("spectrum"));
-
-    // Tuning Frequency
+    // Tuning Frequency, the HPCP is named so a reused network can be
+    // configured with the tuning frequency of the next file
     Real tuningFreq = pool.value<vector<Real> >(tonalspace + "tuning_frequency").back();
 
-    // HPCP Key
-    Algorithm *hpcp_key = factory.create("HPCP",
-                                         "size", 36,
-                                         "referenceFrequency", tuningFreq,
-                                         "bandPreset", false,
-                                         "minFrequency", 40.0,
-                                         "maxFrequency", 5000.0,
-                                         "weightType", "squaredCosine",
-                                         "nonLinear", false,
-                                         "windowSize", 4.0 / 3.0);
-    connect(peaks->output("frequencies"), hpcp_key->input("frequencies"));
-    connect(peaks->output("magnitudes"), hpcp_key->input("magnitudes"));
-    connect(hpcp_key->output("hpcp"), pool, tonalspace + "hpcp");
+    // HPCP Key, Chord and Tuning in one pass over the peaks, see TonalHPCP
+    // for the configuration of every profile
+    Algorithm *hpcp = factory.create("TonalHPCP",
+                                     "referenceFrequency", tuningFreq,
+                                     "minFrequency", 40.0,
+                                     "maxFrequency", 5000.0,
+                                     "splitFrequency", 500.0,
+                                     "harmonics", 8,
+                                     "keySize", 36,
+                                     "keyWindowSize", 4.0 / 3.0,
+                                     "chordSize", 36,
+                                     "highResSize", 120,
+                                     "windowSize", 0.5);
+    hpcp->setName("tonal_hpcp");
+    connect(frequencies, hpcp->input("frequencies"));
+    connect(magnitudes, hpcp->input("magnitudes"));
+    // the tuning system features only need the mean of both HPCP, the
+    // frames are only kept if the statistics need them
+    Real framePeriod = options.tonal.hopSize / options.analysisSampleRate;
+    essentiawrapper::connectDescriptor(hpcp->output("hpcpKey"), stats, nullptr, pool, tonalspace + "hpcp", framePeriod);
+    connectMean(hpcp->output("hpcpKey"), tuningMeans, pool, tonalspace + "hpcp");
+    connectMean(hpcp->output("hpcpHighRes"), tuningMeans, pool, tonalspace + "hpcp_highres");
 
     // native streaming Key algo
     Algorithm *skey = factory.create("Key");
-    connect(hpcp_key->output("hpcp"), skey->input("pcp"));
+    connect(hpcp->output("hpcpKey"), skey->input("pcp"));
     connect(skey->output("key"), pool, tonalspace + "key_key");
     connect(skey->output("scale"), pool, tonalspace + "key_scale");
     connect(skey->output("strength"), pool, tonalspace + "key_strength");
 
-    // HPCP Chord
-    Algorithm *hpcp_chord = factory.create("HPCP",
-                                           "size", 36,
-                                           "referenceFrequency", tuningFreq,
-                                           "harmonics", 8,
-                                           "bandPreset", true,
-                                           "minFrequency", 40.0,
-                                           "maxFrequency", 5000.0,
-                                           "splitFrequency", 500.0,
-                                           "weightType", "cosine",
-                                           "nonLinear", true,
-                                           "windowSize", 0.5);
-    connect(peaks->output("frequencies"), hpcp_chord->input("frequencies"));
-    connect(peaks->output("magnitudes"), hpcp_chord->input("magnitudes"));
-
     // native streaming chords algo
     Algorithm *schord = factory.create("ChordsDetection");
-    connect(hpcp_chord->output("hpcp"), schord->input("pcp"));
+    connect(hpcp->output("hpcpChord"), schord->input("pcp"));
     connect(schord->output("chords"), pool, tonalspace + "chords_progression");
     connect(schord->output("strength"), pool, tonalspace + "chords_strength");
 
@@ -235,23 +215,6 @@ void TonalDescriptors(SourceBase &input, Pool &pool, const Pool &options, const
     connect(schords_desc->output("chordsChangesRate"), pool, tonalspace + "chords_changes_rate");
     connect(schords_desc->output("chordsKey"), pool, tonalspace + "chords_key");
     connect(schords_desc->output("chordsScale"), pool, tonalspace + "chords_scale");
-
-    // HPCP Tuning
-    Algorithm *hpcp_tuning = factory.create("HPCP",
-                                            "size", 120,
-                                            "referenceFrequency", tuningFreq,
-                                            "harmonics", 8,
-                                            "bandPreset", true,
-                                            "minFrequency", 40.0,
-                                            "maxFrequency", 5000.0,
-                                            "splitFrequency", 500.0,
-                                            "weightType", "cosine",
-                                            "nonLinear", true,
-                                            "windowSize", 0.5);
-    connect(peaks->output("frequencies"), hpcp_tuning->input("frequencies"));
-    connect(peaks->output("magnitudes"), hpcp_tuning->input("magnitudes"));
-
-    connect(hpcp_tuning->output("hpcp"), pool, tonalspace + "hpcp_highres");
 }
 
 
@@ -268,7 +231,4 @@ void TonalPoolCleaning(Pool &pool, const string &nspace)
     Real tuningFreq = pool.value<vector<Real> >(tonalspace + "tuning_frequency").back();
     pool.remove(tonalspace + "tuning_frequency");
     pool.set(tonalspace + "tuning_frequency", tuningFreq);
-
-    // remove the highres hpcp which were only used to compute other features
-    pool.remove(tonalspace + "hpcp_highres");
 }
@@ -27,14 +27,22 @@
 #include "streaming/sourcebase.h"
 #include "pool.h"
 #include "types.h"
+#include "../configuration/analysis_options.h"
+#include "streaming_spectralfrontend.h"
+#include "../standard/StreamTonalPeaks.h"
+#include "../standard/FrameStatistics.h"
 
 using namespace std;
 using namespace essentia;
 using namespace essentia::streaming;
+using essentiawrapper::TonalPeaks;
+using essentiawrapper::DescriptorStatistics;
+using essentiawrapper::DescriptorMeans;
 
-void TuningFrequency(SourceBase &input, Pool &pool, const Pool &options, const string &nspace = "");
-void TonalDescriptors(SourceBase &input, Pool &pool, const Pool &options, const string &nspace = "");
-void TuningSystemFeatures(Pool &pool, const string &nspace = "");
+void TuningFrequency(SourceBase &input, SpectralFrontEnd &frontEnd, TonalPeaks *peaksStore, Pool &pool, const AnalysisOptions &options, const string &nspace = "");
+void TonalDescriptors(SourceBase &frequencies, SourceBase &magnitudes, Pool &pool, DescriptorStatistics *stats, DescriptorMeans &tuningMeans,
+                      const AnalysisOptions &options, const string &nspace = "");
+void TuningSystemFeatures(Pool &pool, const DescriptorMeans &tuningMeans, const string &nspace = "");
 void TonalPoolCleaning(Pool &pool, const string &nspace = "");
 
 #endif // STREAMING_EXTRACTORTONAL_H
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "streaming_spectralfrontend.h"
+
+#include "algorithmfactory.h"
+
+SourceBase &SpectralFrontEnd::frames(SourceBase &input, const FrameOptions &frame)
+{
+    return chain(input, frame).frameCutter->output("frame");
+}
+
+SourceBase &SpectralFrontEnd::spectrum(SourceBase &input, const FrameOptions &frame)
+{
+    Chain &c = chain(input, frame);
+
+    for (const Spectrum &s : c.spectra)
+    {
+        if (s.windowType == frame.windowType && s.zeroPadding == frame.zeroPadding)
+        {
+            return s.spectrum->output("spectrum");
+        }
+    }
+
+    streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
+
+    // Windowing
+    Algorithm *w = factory.create("Windowing",
+                                  "type", frame.windowType,
+                                  "zeroPadding", frame.zeroPadding);
+    connect(c.frameCutter->output("frame"), w->input("frame"));
+
+    // Spectrum
+    Spectrum s;
+    s.windowType = frame.windowType;
+    s.zeroPadding = frame.zeroPadding;
+    s.spectrum = factory.create("Spectrum");
+    connect(w->output("frame"), s.spectrum->input("frame"));
+
+    c.spectra.push_back(s);
+    return s.spectrum->output("spectrum");
+}
+
+SpectralFrontEnd::Chain &SpectralFrontEnd::chain(SourceBase &input, const FrameOptions &frame)
+{
+    for (Chain &c : _chains)
+    {
+        if (c.input == &input &&
+                c.frameSize == frame.frameSize &&
+                c.hopSize == frame.hopSize &&
+                c.silentFrames == frame.silentFrames)
+        {
+            return c;
+        }
+    }
+
+    streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
+
+    Chain c;
+    c.input = &input;
+    c.frameSize = frame.frameSize;
+    c.hopSize = frame.hopSize;
+    c.silentFrames = frame.silentFrames;
+
+    // FrameCutter
+    c.frameCutter = factory.create("FrameCutter",
+                                   "frameSize", frame.frameSize,
+                                   "hopSize", frame.hopSize,
+                                   "silentFrames", frame.silentFrames);
+    connect(input, c.frameCutter->input("signal"));
+
+    _chains.push_back(c);
+    return _chains.back();
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef STREAMING_SPECTRALFRONTEND_H
+#define STREAMING_SPECTRALFRONTEND_H
+
+#include "streaming/streamingalgorithm.h"
+#include "streaming/sourcebase.h"
+#include "types.h"
+#include "../configuration/analysis_options.h"
+
+#include <vector>
+
+using namespace std;
+using namespace essentia;
+using namespace essentia::streaming;
+
+/**
+ * @brief The SpectralFrontEnd class builds the FrameCutter -> Windowing ->
+ * Spectrum chains of one network.
+ *
+ * The extractors ask the front end for the frames or the spectrum of a source
+ * instead of creating their own chain, so every distinct combination of
+ * source, framing and window is cut and transformed only once per frame. The
+ * algorithms belong to the network, the front end is only needed while the
+ * network is built.
+ */
+class SpectralFrontEnd
+{
+public:
+    // the FrameCutter output of the source
+    SourceBase &frames(SourceBase &input, const FrameOptions &frame);
+
+    // the Spectrum output of the windowed frames of the source
+    SourceBase &spectrum(SourceBase &input, const FrameOptions &frame);
+
+private:
+    struct Spectrum
+    {
+        string windowType;
+        int zeroPadding;
+        Algorithm *spectrum;
+    };
+
+    struct Chain
+    {
+        SourceBase *input;
+        int frameSize;
+        int hopSize;
+        string silentFrames;
+        Algorithm *frameCutter;
+        vector<Spectrum> spectra;
+    };
+
+    Chain &chain(SourceBase &input, const FrameOptions &frame);
+
+    vector<Chain> _chains;
+};
+
+#endif // STREAMING_SPECTRALFRONTEND_H
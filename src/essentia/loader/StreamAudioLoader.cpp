@@ -66,7 +66,7 @@ streaming::AlgorithmStatus StreamAudioLoader::process()
     std::shared_ptr<audio_buffer> audioBuffer;
     const char* data = nullptr;
 
-    if(_callback)
+    if(_callback && _callback->read_audio)
     {
         audioBuffer.reset(_callback->read_audio(_callback->audio_file), _callback->free_audio_buffer);
         if(audioBuffer)
@@ -133,7 +133,7 @@ void StreamAudioLoader::reset()
 
 void StreamAudioLoader::openAudio()
 {
-    if(_callback)
+    if(_callback && _callback->open_audio)
     {
         _callback->open_audio(_callback->audio_file, 44100, 2, Float);
     }
@@ -141,7 +141,7 @@ void StreamAudioLoader::openAudio()
 
 void StreamAudioLoader::closeAudio()
 {
-    if(_callback)
+    if(_callback && _callback->close_audio)
     {
         _callback->close_audio(_callback->audio_file);
     }
@@ -28,13 +28,13 @@
 
 namespace essentiawrapper {
 
-StreamEasyLoader::StreamEasyLoader(const callbacks *cb) : AlgorithmComposite()
+StreamEasyLoader::StreamEasyLoader(const callbacks *cb, bool stereoOutput) : AlgorithmComposite()
 {
     cout << "-------- create StreamEasyLoader --------" << endl;
 
     declareOutput(_audio, "audio", "the output audio signal");
 
-    _monoLoader.reset(new StreamMonoLoader(cb));
+    _monoLoader.reset(new StreamMonoLoader(cb, stereoOutput));
 
     streaming::AlgorithmFactory &factory = streaming::AlgorithmFactory::instance();
 
@@ -45,6 +45,12 @@ StreamEasyLoader::StreamEasyLoader(const callbacks *cb) : AlgorithmComposite()
     _trimmer->output("signal")    >>  _scale->input("signal");
 
     attach(_scale->output("signal"), _audio);
+
+    if (stereoOutput)
+    {
+        declareOutput(_stereo, "stereo", "the stereo audio signal");
+        attach(_monoLoader->output("stereo"), _stereo);
+    }
 }
 
 void StreamEasyLoader::declareParameters()
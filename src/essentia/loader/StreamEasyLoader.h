@@ -44,11 +44,14 @@ protected:
     shared_ptr<streaming::Algorithm> _scale;
 
     streaming::SourceProxy<AudioSample> _audio;
+    streaming::SourceProxy<StereoSample> _stereo;
 
     bool _configured = false;
 
 public:
-    StreamEasyLoader(const callbacks *cb);
+    // with stereoOutput the decoded stereo signal, neither trimmed nor
+    // scaled, is available as "stereo"
+    StreamEasyLoader(const callbacks *cb, bool stereoOutput = false);
     virtual ~StreamEasyLoader() = default;
 
     virtual void declareProcessOrder() override
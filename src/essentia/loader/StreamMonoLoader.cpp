@@ -28,7 +28,7 @@ using namespace std;
 
 namespace essentiawrapper {
 
-StreamMonoLoader::StreamMonoLoader(const callbacks *cb) : AlgorithmComposite()
+StreamMonoLoader::StreamMonoLoader(const callbacks *cb, bool stereoOutput) : AlgorithmComposite()
 {
     cout << "-------- create StreamMonoLoader --------" << endl;
 
@@ -43,6 +43,12 @@ StreamMonoLoader::StreamMonoLoader(const callbacks *cb) : AlgorithmComposite()
     _audioLoader->output("numberChannels")  >>  _mixer->input("numberChannels");
 
     attach(_mixer->output("audio"), _audio);
+
+    if (stereoOutput)
+    {
+        declareOutput(_stereo, "stereo", "the stereo audio signal");
+        attach(_audioLoader->output("audio"), _stereo);
+    }
 }
 
 void StreamMonoLoader::declareParameters()
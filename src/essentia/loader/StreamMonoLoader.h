@@ -42,11 +42,13 @@ protected:
     std::shared_ptr<streaming::Algorithm> _mixer;
 
     streaming::SourceProxy<AudioSample> _audio;
+    streaming::SourceProxy<StereoSample> _stereo;
 
     bool _configured = false;
 
 public:
-    StreamMonoLoader(const callbacks *cb);
+    // with stereoOutput the decoded stereo signal is available as "stereo"
+    StreamMonoLoader(const callbacks *cb, bool stereoOutput = false);
     virtual ~StreamMonoLoader() = default;
 
     virtual void declareProcessOrder() override
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "DescriptorRegistry.h"
+
+namespace essentiawrapper {
+
+DescriptorRegistry &DescriptorRegistry::instance()
+{
+    static DescriptorRegistry registry;
+    return registry;
+}
+
+DescriptorId DescriptorRegistry::intern(const string &name)
+{
+    lock_guard<mutex> lock(_mutex);
+
+    unordered_map<string, DescriptorId>::const_iterator it = _ids.find(name);
+    if (it != _ids.end()) return it->second;
+
+    DescriptorId id = DescriptorId(_names.size());
+    _names.push_back(name);
+    _ids[name] = id;
+
+    return id;
+}
+
+const string &DescriptorRegistry::name(DescriptorId id) const
+{
+    lock_guard<mutex> lock(_mutex);
+
+    if (id >= _names.size())
+    {
+        throw EssentiaException("DescriptorRegistry: unknown descriptor id");
+    }
+
+    return _names[id];
+}
+
+} // namespace essentiawrapper
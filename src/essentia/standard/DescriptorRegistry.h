@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef DESCRIPTOR_REGISTRY_H
+#define DESCRIPTOR_REGISTRY_H
+
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "pool.h"
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+typedef uint32_t DescriptorId;
+
+/**
+ * @brief Interns the descriptor names to integer ids.
+ *
+ * The names are interned when the networks are built, the sinks and the
+ * aggregation then index their descriptors by id and the names are only
+ * looked up again to write the results. The ids are process wide and never
+ * reused, so plans built on different threads agree on them.
+ */
+class DescriptorRegistry
+{
+public:
+    static DescriptorRegistry &instance();
+
+    DescriptorId intern(const string &name);
+
+    // the reference stays valid for the lifetime of the process
+    const string &name(DescriptorId id) const;
+
+private:
+    DescriptorRegistry() = default;
+    DescriptorRegistry(const DescriptorRegistry &) = delete;
+    DescriptorRegistry &operator=(const DescriptorRegistry &) = delete;
+
+    mutable mutex _mutex;
+    unordered_map<string, DescriptorId> _ids;
+    deque<string> _names;
+};
+
+/**
+ * @brief The values of the descriptors of the result pools, by pool and
+ * descriptor id. The values keep their address, the sinks of a network
+ * built once point to them for every file.
+ */
+template <typename T>
+class DescriptorTable
+{
+public:
+    struct Entry
+    {
+        const Pool *pool;
+        DescriptorId id;
+        T value;
+    };
+
+    T *add(const Pool &pool, DescriptorId id)
+    {
+        pair<const Pool *, DescriptorId> key(&pool, id);
+
+        typename map<pair<const Pool *, DescriptorId>, size_t>::const_iterator it = _index.find(key);
+        if (it != _index.end()) return &_entries[it->second].value;
+
+        _index[key] = _entries.size();
+        _entries.push_back(Entry { &pool, id, T() });
+        return &_entries.back().value;
+    }
+
+    const T *find(const Pool &pool, DescriptorId id) const
+    {
+        typename map<pair<const Pool *, DescriptorId>, size_t>::const_iterator it = _index.find(make_pair(&pool, id));
+        if (it == _index.end()) return nullptr;
+
+        return &_entries[it->second].value;
+    }
+
+    // in the order the descriptors were added
+    deque<Entry> &entries() { return _entries; }
+    const deque<Entry> &entries() const { return _entries; }
+
+private:
+    deque<Entry> _entries;
+    map<pair<const Pool *, DescriptorId>, size_t> _index;
+};
+
+} // namespace essentiawrapper
+
+#endif // DESCRIPTOR_REGISTRY_H
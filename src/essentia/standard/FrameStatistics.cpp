@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "FrameStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace essentiawrapper {
+
+const size_t QuantileSketch::defaultCapacity;
+
+QuantileSketch::QuantileSketch(size_t capacity) : _capacity(max(capacity + capacity % 2, size_t(2))), _count(0)
+{
+    _levels.resize(1);
+    _keepOdd.resize(1, false);
+}
+
+void QuantileSketch::add(Real value)
+{
+    _levels[0].push_back(value);
+    ++_count;
+
+    if (_levels[0].size() >= _capacity) compact(0);
+}
+
+void QuantileSketch::clear()
+{
+    // keeps the buffers, the next file has about as many frames
+    for (vector<Real> &level : _levels) level.clear();
+    _keepOdd.assign(_keepOdd.size(), false);
+    _count = 0;
+}
+
+void QuantileSketch::compact(size_t level)
+{
+    if (level + 1 == _levels.size())
+    {
+        _levels.push_back(vector<Real>());
+        _keepOdd.push_back(false);
+    }
+
+    vector<Real> &values = _levels[level];
+    sort(values.begin(), values.end());
+
+    vector<Real> &next = _levels[level + 1];
+    for (size_t i = _keepOdd[level] ? 1 : 0; i < values.size(); i += 2)
+    {
+        next.push_back(values[i]);
+    }
+
+    // alternating the kept half keeps the estimate unbiased
+    _keepOdd[level] = !_keepOdd[level];
+    values.clear();
+
+    if (next.size() >= _capacity) compact(level + 1);
+}
+
+Real QuantileSketch::median() const
+{
+    if (_count == 0)
+    {
+        throw EssentiaException("QuantileSketch: trying to calculate median of empty array");
+    }
+
+    bool exact = true;
+    for (size_t level = 1; level < _levels.size(); ++level)
+    {
+        if (!_levels[level].empty()) exact = false;
+    }
+
+    // as long as nothing was compacted, the same value as essentia::median()
+    if (exact)
+    {
+        vector<Real> sorted = _levels[0];
+        sort(sorted.begin(), sorted.end());
+
+        size_t size = sorted.size();
+        if (size % 2 == 0) return (sorted[size / 2 - 1] + sorted[size / 2]) / 2;
+        return sorted[size / 2];
+    }
+
+    vector<pair<Real, size_t> > weighted;
+    size_t total = 0;
+    for (size_t level = 0; level < _levels.size(); ++level)
+    {
+        size_t weight = size_t(1) << level;
+        for (Real value : _levels[level])
+        {
+            weighted.push_back(make_pair(value, weight));
+            total += weight;
+        }
+    }
+    sort(weighted.begin(), weighted.end());
+
+    size_t cumulated = 0;
+    for (const pair<Real, size_t> &item : weighted)
+    {
+        cumulated += item.second;
+        if (2 * cumulated >= total) return item.first;
+    }
+
+    return weighted.back().first;
+}
+
+FrameStatistics::FrameStatistics() : _scalar(true), _frames(0)
+{
+}
+
+void FrameStatistics::clear()
+{
+    _frames = 0;
+
+    _values.clear();
+    _derivative.clear();
+    _derivative2.clear();
+    _min.clear();
+    _max.clear();
+    _previous.clear();
+    _previousDerivative.clear();
+
+    for (QuantileSketch &sketch : _medians) sketch.clear();
+}
+
+void FrameStatistics::add(Real value)
+{
+    _scalar = true;
+    addFrame(&value, 1);
+}
+
+void FrameStatistics::add(const vector<Real> &frame)
+{
+    _scalar = false;
+    addFrame(frame.data(), frame.size());
+}
+
+void FrameStatistics::addFrame(const Real *frame, size_t size)
+{
+    if (_frames == 0)
+    {
+        _values.assign(size, Moments());
+        _derivative.assign(size, Moments());
+        _derivative2.assign(size, Moments());
+        _min.assign(frame, frame + size);
+        _max.assign(frame, frame + size);
+        _previous.assign(size, 0.0);
+        _previousDerivative.assign(size, 0.0);
+        _medians.resize(size);
+    }
+    else if (size != _values.size())
+    {
+        throw EssentiaException("FrameStatistics: the frames of a descriptor must have the same size");
+    }
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        Real value = frame[i];
+
+        _values[i].add(value);
+        _min[i] = min(_min[i], value);
+        _max[i] = max(_max[i], value);
+        _medians[i].add(value);
+
+        // the second derivative is taken on the signed first derivative,
+        // both are summarized on their absolute values
+        if (_frames >= 1)
+        {
+            Real derivative = value - _previous[i];
+            _derivative[i].add(fabs(derivative));
+
+            if (_frames >= 2)
+            {
+                _derivative2[i].add(fabs(derivative - _previousDerivative[i]));
+            }
+            _previousDerivative[i] = derivative;
+        }
+        _previous[i] = value;
+    }
+
+    ++_frames;
+}
+
+bool FrameStatistics::supports(const vector<string> &stats)
+{
+    static const char *supported[] = { "mean", "var", "median", "min", "max", "dmean", "dvar", "dmean2", "dvar2" };
+
+    for (const string &stat : stats)
+    {
+        if (find(begin(supported), end(supported), stat) == end(supported)) return false;
+    }
+    return true;
+}
+
+void FrameStatistics::aggregate(Pool &output, const string &name, const vector<string> &stats) const
+{
+    if (_frames == 0) return;
+
+    size_t size = _values.size();
+    vector<Real> result(size);
+
+    for (const string &stat : stats)
+    {
+        // the derivatives need two and three frames
+        if ((stat == "dmean" || stat == "dvar") && _frames < 2) continue;
+        if ((stat == "dmean2" || stat == "dvar2") && _frames < 3) continue;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            if      (stat == "mean")   result[i] = Real(_values[i].mean);
+            else if (stat == "var")    result[i] = Real(_values[i].variance());
+            else if (stat == "median") result[i] = _medians[i].median();
+            else if (stat == "min")    result[i] = _min[i];
+            else if (stat == "max")    result[i] = _max[i];
+            else if (stat == "dmean")  result[i] = Real(_derivative[i].mean);
+            else if (stat == "dvar")   result[i] = Real(_derivative[i].variance());
+            else if (stat == "dmean2") result[i] = Real(_derivative2[i].mean);
+            else if (stat == "dvar2")  result[i] = Real(_derivative2[i].variance());
+            else throw EssentiaException("FrameStatistics: unsupported statistic " + stat);
+        }
+
+        if (_scalar) output.set(name + "." + stat, result[0]);
+        else output.set(name + "." + stat, result);
+    }
+}
+
+void DescriptorStatistics::clear()
+{
+    for (Table::Entry &entry : _descriptors.entries()) entry.value.clear();
+}
+
+void FrameMean::add(const vector<Real> &frame)
+{
+    if (_frames == 0)
+    {
+        _sum.assign(frame.size(), 0.0);
+    }
+    else if (frame.size() != _sum.size())
+    {
+        throw EssentiaException("FrameMean: the frames of a descriptor must have the same size");
+    }
+
+    for (size_t i = 0; i < frame.size(); ++i) _sum[i] += frame[i];
+    ++_frames;
+}
+
+void FrameMean::clear()
+{
+    _sum.clear();
+    _frames = 0;
+}
+
+vector<Real> FrameMean::mean() const
+{
+    if (_frames == 0)
+    {
+        throw EssentiaException("FrameMean: trying to calculate mean of empty array");
+    }
+
+    vector<Real> result(_sum);
+    for (size_t i = 0; i < result.size(); ++i) result[i] /= _frames;
+    return result;
+}
+
+void DescriptorMeans::clear()
+{
+    for (Table::Entry &entry : _descriptors.entries()) entry.value.clear();
+}
+
+} // namespace essentiawrapper
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef FRAME_STATISTICS_H
+#define FRAME_STATISTICS_H
+
+#include <string>
+#include <vector>
+
+#include "DescriptorRegistry.h"
+#include "pool.h"
+#include "types.h"
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+/**
+ * @brief Estimates the median of a stream in bounded memory.
+ *
+ * The values are kept exactly until the first buffer is full, then the
+ * buffers are compacted by sorting them and keeping every other value with
+ * twice the weight, alternating which half is kept. The memory grows with the
+ * logarithm of the number of values.
+ *
+ * The default capacity keeps the median exact for 32767 frames, about 12
+ * minutes at the low level hop size of 1024 samples at 44.1 kHz; it is an
+ * approximation for longer recordings.
+ */
+class QuantileSketch
+{
+public:
+    static const size_t defaultCapacity = 32768;
+
+    explicit QuantileSketch(size_t capacity = defaultCapacity);
+
+    void add(Real value);
+    void clear();
+
+    size_t count() const { return _count; }
+    Real median() const;
+
+private:
+    size_t _capacity;
+    size_t _count;
+    vector<vector<Real> > _levels; // the values of level i weigh 2^i
+    vector<bool> _keepOdd;         // the half kept by the next compaction
+
+    void compact(size_t level);
+};
+
+/**
+ * @brief Computes the statistics of PoolAggregator over the frames of one
+ * descriptor as they are produced, without keeping the frames.
+ *
+ * The mean and variance are accumulated with Welford's method, the derivative
+ * statistics on the absolute differences of consecutive frames and the median
+ * with a QuantileSketch per dimension.
+ */
+class FrameStatistics
+{
+public:
+    FrameStatistics();
+
+    void add(Real value);
+    void add(const vector<Real> &frame);
+    void clear();
+
+    size_t frames() const { return _frames; }
+
+    /**
+     * @brief Sets the requested statistics in the output pool, with the
+     * names and types PoolAggregator gives them.
+     */
+    void aggregate(Pool &output, const string &name, const vector<string> &stats) const;
+
+    /**
+     * @brief Whether all the statistics can be computed without the frames.
+     */
+    static bool supports(const vector<string> &stats);
+
+private:
+    struct Moments
+    {
+        size_t count;
+        double mean;
+        double m2;
+
+        Moments() : count(0), mean(0.0), m2(0.0) {}
+
+        void add(double value)
+        {
+            ++count;
+            double delta = value - mean;
+            mean += delta / count;
+            m2 += delta * (value - mean);
+        }
+
+        double variance() const { return m2 / count; }
+    };
+
+    bool _scalar;
+    size_t _frames;
+
+    vector<Moments> _values;
+    vector<Moments> _derivative;
+    vector<Moments> _derivative2;
+    vector<Real> _min;
+    vector<Real> _max;
+    vector<Real> _previous;
+    vector<Real> _previousDerivative;
+    vector<QuantileSketch> _medians;
+
+    void addFrame(const Real *frame, size_t size);
+};
+
+/**
+ * @brief The statistics of the descriptors that are aggregated while
+ * streaming, by pool and descriptor id.
+ */
+class DescriptorStatistics
+{
+public:
+    typedef DescriptorTable<FrameStatistics> Table;
+
+    FrameStatistics *add(const Pool &pool, DescriptorId id) { return _descriptors.add(pool, id); }
+
+    // resets the statistics, the entries are kept for the sinks
+    void clear();
+
+    const Table &descriptors() const { return _descriptors; }
+
+private:
+    Table _descriptors;
+};
+
+/**
+ * @brief The mean of every dimension of a vector descriptor, summed as
+ * meanFrames does, for the descriptors only their mean is needed of.
+ */
+class FrameMean
+{
+public:
+    FrameMean() : _frames(0) {}
+
+    void add(const vector<Real> &frame);
+    void clear();
+
+    size_t frames() const { return _frames; }
+    vector<Real> mean() const;
+
+private:
+    vector<Real> _sum;
+    size_t _frames;
+};
+
+/**
+ * @brief The means of the descriptors that are not kept in the pool, by pool
+ * and descriptor id.
+ */
+class DescriptorMeans
+{
+public:
+    typedef DescriptorTable<FrameMean> Table;
+
+    FrameMean *add(const Pool &pool, DescriptorId id) { return _descriptors.add(pool, id); }
+    const FrameMean *find(const Pool &pool, DescriptorId id) const { return _descriptors.find(pool, id); }
+
+    // resets the means, the entries are kept for the sinks
+    void clear();
+
+private:
+    Table _descriptors;
+};
+
+} // namespace essentiawrapper
+
+#endif // FRAME_STATISTICS_H
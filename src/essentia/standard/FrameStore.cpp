@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "FrameStore.h"
+
+#include <algorithm>
+
+namespace essentiawrapper {
+
+const size_t FrameMatrix::chunkFrames;
+
+void FrameMatrix::append(const vector<Real> &frame)
+{
+    if (_frames == 0)
+    {
+        // the chunks are sized for the dimension of the first frame
+        if (frame.size() != _dims) _chunks.clear();
+        _dims = frame.size();
+    }
+    else if (frame.size() != _dims)
+    {
+        throw EssentiaException("FrameMatrix: the frames of a descriptor must have the same size");
+    }
+
+    size_t chunk = _frames / chunkFrames;
+    if (chunk == _chunks.size())
+    {
+        _chunks.push_back(HostVector<Real>(chunkFrames * _dims));
+    }
+
+    copy(frame.begin(), frame.end(), _chunks[chunk].begin() + (_frames % chunkFrames) * _dims);
+    ++_frames;
+}
+
+TNT::Array2D<Real> FrameMatrix::transposed() const
+{
+    TNT::Array2D<Real> result((int)_dims, (int)_frames);
+
+    for (size_t frame = 0; frame < _frames; ++frame)
+    {
+        const Real *values = row(frame);
+        for (size_t dim = 0; dim < _dims; ++dim)
+        {
+            result[dim][frame] = values[dim];
+        }
+    }
+
+    return result;
+}
+
+void FrameMatrix::exportTo(Pool &pool, const string &name) const
+{
+    vector<Real> frame(_dims);
+    for (size_t i = 0; i < _frames; ++i)
+    {
+        const Real *values = row(i);
+        frame.assign(values, values + _dims);
+        pool.add(name, frame);
+    }
+}
+
+void FrameStore::clear()
+{
+    for (Table::Entry &entry : _descriptors.entries()) entry.value.clear();
+}
+
+void FrameStore::exportTo(Pool &pool) const
+{
+    DescriptorRegistry &registry = DescriptorRegistry::instance();
+
+    for (const Table::Entry &entry : _descriptors.entries())
+    {
+        if (entry.pool == &pool) entry.value.exportTo(pool, registry.name(entry.id));
+    }
+}
+
+} // namespace essentiawrapper
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef FRAME_STORE_H
+#define FRAME_STORE_H
+
+#include <string>
+#include <vector>
+
+#include "DescriptorRegistry.h"
+#include "../HostAllocator.h"
+#include "pool.h"
+#include "types.h"
+#include "utils/tnt/tnt.h"
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+/**
+ * @brief The frames of one vector descriptor as a frames x dims matrix.
+ *
+ * The rows are kept in chunks of contiguous memory, so appending a frame
+ * neither allocates per frame nor moves the frames already stored. The
+ * chunks are taken from the arena of the analysis.
+ */
+class FrameMatrix
+{
+public:
+    static const size_t chunkFrames = 512;
+
+    FrameMatrix() : _dims(0), _frames(0) {}
+
+    void append(const vector<Real> &frame);
+
+    // the memory of the chunks is kept by the arena of the analysis
+    void clear() { _chunks.clear(); _frames = 0; }
+
+    size_t frames() const { return _frames; }
+    size_t dims() const { return _dims; }
+
+    const Real *row(size_t frame) const
+    {
+        return &_chunks[frame / chunkFrames][(frame % chunkFrames) * _dims];
+    }
+
+    /**
+     * @brief The transposed matrix, dims x frames, as the BIC segmentation
+     * takes its features.
+     */
+    TNT::Array2D<Real> transposed() const;
+
+    /**
+     * @brief Adds the frames to the pool, as the pool storage would have.
+     */
+    void exportTo(Pool &pool, const string &name) const;
+
+private:
+    size_t _dims;
+    size_t _frames;
+    vector<HostVector<Real> > _chunks;
+};
+
+/**
+ * @brief The frames of the vector descriptors kept outside the pools, by
+ * pool and descriptor id.
+ */
+class FrameStore
+{
+public:
+    typedef DescriptorTable<FrameMatrix> Table;
+
+    FrameMatrix *add(const Pool &pool, DescriptorId id) { return _descriptors.add(pool, id); }
+
+    // the frames of a descriptor, nullptr if it is not in the store
+    const FrameMatrix *find(const Pool &pool, DescriptorId id) const { return _descriptors.find(pool, id); }
+
+    // empties the matrices, the entries are kept for the sinks
+    void clear();
+
+    /**
+     * @brief Adds the frames stored for @e pool to it, for the aggregation
+     * and the output.
+     */
+    void exportTo(Pool &pool) const;
+
+private:
+    Table _descriptors;
+};
+
+} // namespace essentiawrapper
+
+#endif // FRAME_STORE_H
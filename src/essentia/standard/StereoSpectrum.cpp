@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "StereoSpectrum.h"
+
+#include "algorithmfactory.h"
+
+namespace essentiawrapper {
+
+const char *StereoSpectrum::name = "StereoSpectrum";
+const char *StereoSpectrum::category = "Spectral";
+const char *StereoSpectrum::description = "Computes the magnitude spectra of a left and a right frame with one complex FFT.";
+
+StereoSpectrum::StereoSpectrum() : _fftSize(0), _joint(true)
+{
+    declareInput(_left, "left", "the left frame");
+    declareInput(_right, "right", "the right frame");
+    declareOutput(_spectrumLeft, "spectrumLeft", "the magnitude spectrum of the left frame");
+    declareOutput(_spectrumRight, "spectrumRight", "the magnitude spectrum of the right frame");
+}
+
+void StereoSpectrum::declareParameters()
+{
+    declareParameter("size", "the expected size of the frames", "[1,inf)", 2048);
+}
+
+void StereoSpectrum::configure()
+{
+    configureFFT(parameter("size").toInt(), true);
+}
+
+void StereoSpectrum::configureFFT(int size, bool joint)
+{
+    standard::AlgorithmFactory &factory = standard::AlgorithmFactory::instance();
+
+    _fftSize = size;
+    _joint = joint;
+
+    if (_joint)
+    {
+        _fft.reset(factory.create("FFTC"));
+        try
+        {
+            _fft->configure("size", size,
+                            "negativeFrequencies", true);
+            return;
+        }
+        catch (EssentiaException &)
+        {
+            // older essentia versions only have the positive frequencies
+            _joint = false;
+        }
+    }
+
+    _fft.reset(factory.create("Spectrum"));
+    _fft->configure("size", size);
+}
+
+void StereoSpectrum::magnitude(const vector<Real> &frame, vector<Real> &spectrum)
+{
+    _fft->input("frame").set(frame);
+    _fft->output("spectrum").set(spectrum);
+    _fft->compute();
+}
+
+void StereoSpectrum::compute()
+{
+    const vector<Real> &left = _left.get();
+    const vector<Real> &right = _right.get();
+    vector<Real> &spectrumLeft = _spectrumLeft.get();
+    vector<Real> &spectrumRight = _spectrumRight.get();
+
+    if (left.size() != right.size())
+    {
+        throw EssentiaException("StereoSpectrum: the left and right frames are not of equal size");
+    }
+
+    int size = left.size();
+    if (size != _fftSize)
+    {
+        configureFFT(size, _joint);
+    }
+
+    if (_joint)
+    {
+        _packed.resize(size);
+        for (int i = 0; i < size; ++i)
+        {
+            _packed[i] = complex<Real>(left[i], right[i]);
+        }
+
+        _fft->input("frame").set(_packed);
+        _fft->output("fft").set(_transformed);
+        _fft->compute();
+
+        if (int(_transformed.size()) == size)
+        {
+            // Z = L + iR, with L[k] = conj(L[N-k]) and R[k] = conj(R[N-k])
+            // of the real frames
+            int bins = size / 2 + 1;
+            spectrumLeft.resize(bins);
+            spectrumRight.resize(bins);
+
+            for (int k = 0; k < bins; ++k)
+            {
+                complex<Real> z = _transformed[k];
+                complex<Real> mirrored = conj(_transformed[(size - k) % size]);
+
+                spectrumLeft[k] = abs(z + mirrored) * Real(0.5);
+                spectrumRight[k] = abs(z - mirrored) * Real(0.5);
+            }
+            return;
+        }
+
+        configureFFT(size, false);
+    }
+
+    magnitude(left, spectrumLeft);
+    magnitude(right, spectrumRight);
+}
+
+StreamStereoSpectrum::StreamStereoSpectrum()
+{
+    declareAlgorithm("StereoSpectrum");
+    declareInput(_left, streaming::TOKEN, "left");
+    declareInput(_right, streaming::TOKEN, "right");
+    declareOutput(_spectrumLeft, streaming::TOKEN, "spectrumLeft");
+    declareOutput(_spectrumRight, streaming::TOKEN, "spectrumRight");
+}
+
+} // namespace essentiawrapper
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef STEREO_SPECTRUM_H
+#define STEREO_SPECTRUM_H
+
+#include <complex>
+#include <memory>
+
+#include "algorithm.h"
+#include "streaming/streamingalgorithmwrapper.h"
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+/**
+ * @brief The StereoSpectrum class computes the magnitude spectra of a left
+ * and a right frame, as two Spectrum algorithms would, with one complex FFT.
+ *
+ * The left frame is the real part and the right frame the imaginary part of
+ * the FFT input, the two spectra are separated with the conjugate symmetry of
+ * the spectrum of a real signal. If the complex FFT of essentia only returns
+ * the positive frequencies, both frames are transformed with the real FFT.
+ */
+class StereoSpectrum : public standard::Algorithm
+{
+protected:
+    standard::Input<vector<Real> > _left;
+    standard::Input<vector<Real> > _right;
+    standard::Output<vector<Real> > _spectrumLeft;
+    standard::Output<vector<Real> > _spectrumRight;
+
+    unique_ptr<standard::Algorithm> _fft; // FFTC, or Spectrum if not joint
+    int _fftSize;
+    bool _joint;
+
+    vector<complex<Real> > _packed;
+    vector<complex<Real> > _transformed;
+
+    void configureFFT(int size, bool joint);
+    void magnitude(const vector<Real> &frame, vector<Real> &spectrum);
+
+public:
+    StereoSpectrum();
+    virtual ~StereoSpectrum() = default;
+
+    virtual void declareParameters() override;
+    virtual void configure() override;
+    virtual void compute() override;
+
+    static const char *name;
+    static const char *category;
+    static const char *description;
+
+};
+
+class StreamStereoSpectrum : public streaming::StreamingAlgorithmWrapper
+{
+protected:
+    streaming::Sink<vector<Real> > _left;
+    streaming::Sink<vector<Real> > _right;
+    streaming::Source<vector<Real> > _spectrumLeft;
+    streaming::Source<vector<Real> > _spectrumRight;
+
+public:
+    StreamStereoSpectrum();
+
+};
+
+} // namespace essentiawrapper
+
+#endif // STEREO_SPECTRUM_H
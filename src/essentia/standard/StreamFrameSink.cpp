@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "StreamFrameSink.h"
+
+namespace essentiawrapper {
+
+FrameSinkRegistry &FrameSinkRegistry::instance()
+{
+    static FrameSinkRegistry registry;
+    return registry;
+}
+
+DescriptorId FrameSinkRegistry::set(const string &name, FrameSinkFunction sink)
+{
+    DescriptorId id = DescriptorRegistry::instance().intern(name);
+
+    lock_guard<mutex> lock(_mutex);
+
+    if (sink) _sinks[id] = sink;
+    else _sinks.erase(id);
+
+    return id;
+}
+
+FrameSinkFunction FrameSinkRegistry::find(DescriptorId id) const
+{
+    lock_guard<mutex> lock(_mutex);
+
+    unordered_map<DescriptorId, FrameSinkFunction>::const_iterator it = _sinks.find(id);
+    if (it == _sinks.end()) return nullptr;
+
+    return it->second;
+}
+
+bool connectFrameSink(streaming::SourceBase &source, const string &name, Real framePeriod)
+{
+    DescriptorId id = DescriptorRegistry::instance().intern(name);
+
+    FrameSinkFunction function = FrameSinkRegistry::instance().find(id);
+    if (!function) return false;
+
+    streaming::Algorithm *sink = nullptr;
+    if (sameType(source.typeInfo(), typeid(Real)))
+    {
+        sink = new StreamFrameSink<Real>(function, id, framePeriod);
+    }
+    else if (sameType(source.typeInfo(), typeid(vector<Real>)))
+    {
+        sink = new StreamFrameSink<vector<Real> >(function, id, framePeriod);
+    }
+    else
+    {
+        throw EssentiaException("connectFrameSink: ", name, " is neither a real nor a vector of reals");
+    }
+
+    sink->setName("sink_" + name);
+    streaming::connect(source, sink->input("data"));
+
+    return true;
+}
+
+} // namespace essentiawrapper
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef STREAM_FRAME_SINK_H
+#define STREAM_FRAME_SINK_H
+
+#include <stdint.h>
+#include <mutex>
+#include <unordered_map>
+
+#include "DescriptorRegistry.h"
+
+#include "streaming/streamingalgorithm.h"
+
+namespace essentiawrapper {
+
+/**
+ * @brief Receives the frames of a descriptor while they are computed, with
+ * the id of the descriptor and the time of the frame in seconds from the
+ * start of the analyzed audio. The data is only valid during the call.
+ */
+typedef void (*FrameSinkFunction)(DescriptorId id, double timestamp, const float *data, uint32_t dims);
+
+/**
+ * @brief The frame sinks of the host, by descriptor id.
+ *
+ * The sinks are looked up when the networks are built, a network built once
+ * keeps passing the frames to the sinks registered at that time.
+ */
+class FrameSinkRegistry
+{
+public:
+    static FrameSinkRegistry &instance();
+
+    // a nullptr sink removes the sink of the descriptor
+    DescriptorId set(const string &name, FrameSinkFunction sink);
+
+    FrameSinkFunction find(DescriptorId id) const;
+
+private:
+    FrameSinkRegistry() = default;
+    FrameSinkRegistry(const FrameSinkRegistry &) = delete;
+    FrameSinkRegistry &operator=(const FrameSinkRegistry &) = delete;
+
+    mutable mutex _mutex;
+    unordered_map<DescriptorId, FrameSinkFunction> _sinks;
+};
+
+/**
+ * @brief Sink passing the frames of a descriptor to the frame sink of the
+ * host, in place of the pool storage of the frames.
+ */
+template <typename T>
+class StreamFrameSink : public streaming::Algorithm
+{
+protected:
+
+    streaming::Sink<T> _data;
+
+    FrameSinkFunction _sink;
+    DescriptorId _id;
+    double _framePeriod;
+    uint64_t _frame;
+
+    void send(const Real &value) { _sink(_id, timestamp(), &value, 1); }
+    void send(const vector<Real> &value) { _sink(_id, timestamp(), value.data(), uint32_t(value.size())); }
+
+    double timestamp() const { return double(_frame) * _framePeriod; }
+
+public:
+    StreamFrameSink(FrameSinkFunction sink, DescriptorId id, Real framePeriod) :
+        Algorithm(), _sink(sink), _id(id), _framePeriod(framePeriod), _frame(0)
+    {
+        declareInput(_data, 1, "data", "the frames of the descriptor");
+    }
+    virtual ~StreamFrameSink() = default;
+
+    virtual void declareParameters() override {}
+
+    virtual streaming::AlgorithmStatus process() override
+    {
+        streaming::AlgorithmStatus status = acquireData();
+        if (status != streaming::OK) return status;
+
+        send(_data.firstToken());
+        ++_frame;
+
+        releaseData();
+
+        return streaming::OK;
+    }
+
+    // the next file starts again at 0
+    virtual void reset() override
+    {
+        streaming::Algorithm::reset();
+        _frame = 0;
+    }
+
+};
+
+/**
+ * @brief Connects @e source to the frame sink registered for @e name, if
+ * any, next to its other sinks.
+ * @param framePeriod The hop size of the frames in seconds.
+ * @return false if no sink is registered for the descriptor.
+ */
+bool connectFrameSink(streaming::SourceBase &source, const string &name, Real framePeriod);
+
+} // namespace essentiawrapper
+
+#endif // STREAM_FRAME_SINK_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "StreamFrameStatistics.h"
+#include "StreamFrameSink.h"
+#include "StreamFrameStore.h"
+
+#include "streaming/algorithms/poolstorage.h"
+
+namespace essentiawrapper {
+
+void connectDescriptor(streaming::SourceBase &source, DescriptorStatistics *stats, FrameStore *frames,
+                       Pool &pool, const string &name, Real framePeriod)
+{
+    bool scalar = sameType(source.typeInfo(), typeid(Real));
+    bool vectors = sameType(source.typeInfo(), typeid(vector<Real>));
+
+    // the sinks index their descriptor by id, the name is only needed again
+    // for the results
+    DescriptorId id = DescriptorRegistry::instance().intern(name);
+
+    // next to the other sinks, the frames are only kept if the statistics
+    // need them
+    connectFrameSink(source, name, framePeriod);
+
+    streaming::Algorithm *sink = nullptr;
+    if (stats && scalar)
+    {
+        sink = new StreamFrameStatistics<Real>(stats->add(pool, id));
+        sink->setName("statistics_" + name);
+    }
+    else if (stats && vectors)
+    {
+        sink = new StreamFrameStatistics<vector<Real> >(stats->add(pool, id));
+        sink->setName("statistics_" + name);
+    }
+    else if (frames && vectors)
+    {
+        sink = new StreamFrameStore(frames->add(pool, id));
+        sink->setName("frames_" + name);
+    }
+    else
+    {
+        // other types are aggregated from the pool
+        streaming::connect(source, pool, name);
+        return;
+    }
+
+    streaming::connect(source, sink->input("data"));
+}
+
+} // namespace essentiawrapper
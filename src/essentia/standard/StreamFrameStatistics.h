@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef STREAM_FRAME_STATISTICS_H
+#define STREAM_FRAME_STATISTICS_H
+
+#include "FrameStatistics.h"
+#include "FrameStore.h"
+
+#include "streaming/streamingalgorithm.h"
+
+namespace essentiawrapper {
+
+/**
+ * @brief Sink adding the frames of a descriptor to its FrameStatistics, in
+ * place of the pool storage of the frames.
+ */
+template <typename T>
+class StreamFrameStatistics : public streaming::Algorithm
+{
+protected:
+
+    streaming::Sink<T> _data;
+
+    FrameStatistics *_stats;
+
+public:
+    StreamFrameStatistics(FrameStatistics *stats) : Algorithm(), _stats(stats)
+    {
+        declareInput(_data, 1, "data", "the frames of the descriptor");
+    }
+    virtual ~StreamFrameStatistics() = default;
+
+    virtual void declareParameters() override {}
+
+    virtual streaming::AlgorithmStatus process() override
+    {
+        streaming::AlgorithmStatus status = acquireData();
+        if (status != streaming::OK) return status;
+
+        _stats->add(_data.firstToken());
+
+        releaseData();
+
+        return streaming::OK;
+    }
+
+};
+
+/**
+ * @brief Sink adding the frames of a vector descriptor to its FrameMean.
+ */
+class StreamFrameMean : public streaming::Algorithm
+{
+protected:
+
+    streaming::Sink<vector<Real> > _data;
+
+    FrameMean *_mean;
+
+public:
+    StreamFrameMean(FrameMean *mean) : Algorithm(), _mean(mean)
+    {
+        declareInput(_data, 1, "data", "the frames of the descriptor");
+    }
+    virtual ~StreamFrameMean() = default;
+
+    virtual void declareParameters() override {}
+
+    virtual streaming::AlgorithmStatus process() override
+    {
+        streaming::AlgorithmStatus status = acquireData();
+        if (status != streaming::OK) return status;
+
+        _mean->add(_data.firstToken());
+
+        releaseData();
+
+        return streaming::OK;
+    }
+
+};
+
+/**
+ * @brief Connects a descriptor to the statistics of @e stats. Without
+ * @e stats its frames are kept in @e frames if they are vectors, else in the
+ * pool.
+ *
+ * With a frame sink registered for the descriptor, the frames are also
+ * passed to it. They are still kept when the statistics or the segmentation
+ * need them: in @e frames or in the pool, as without a sink.
+ *
+ * @param framePeriod The hop size of the frames in seconds.
+ */
+void connectDescriptor(streaming::SourceBase &source, DescriptorStatistics *stats, FrameStore *frames,
+                       Pool &pool, const string &name, Real framePeriod);
+
+} // namespace essentiawrapper
+
+#endif // STREAM_FRAME_STATISTICS_H
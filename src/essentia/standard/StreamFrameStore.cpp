@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "StreamFrameStore.h"
+
+namespace essentiawrapper {
+
+StreamFrameStore::StreamFrameStore(FrameMatrix *frames) : Algorithm(), _frames(frames)
+{
+    declareInput(_data, 1, "data", "the frames of the descriptor");
+}
+
+streaming::AlgorithmStatus StreamFrameStore::process()
+{
+    streaming::AlgorithmStatus status = acquireData();
+    if (status != streaming::OK) return status;
+
+    _frames->append(_data.firstToken());
+
+    releaseData();
+
+    return streaming::OK;
+}
+
+} // namespace essentiawrapper
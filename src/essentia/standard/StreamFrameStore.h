@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef STREAM_FRAME_STORE_H
+#define STREAM_FRAME_STORE_H
+
+#include "FrameStore.h"
+
+#include "streaming/streamingalgorithm.h"
+
+namespace essentiawrapper {
+
+/**
+ * @brief Sink appending the frames of a vector descriptor to its FrameMatrix,
+ * in place of the pool storage of the frames.
+ */
+class StreamFrameStore : public streaming::Algorithm
+{
+protected:
+
+    streaming::Sink<vector<Real> > _data;
+
+    FrameMatrix *_frames;
+
+public:
+    StreamFrameStore(FrameMatrix *frames);
+    virtual ~StreamFrameStore() = default;
+
+    virtual void declareParameters() override {}
+    virtual streaming::AlgorithmStatus process() override;
+
+};
+
+} // namespace essentiawrapper
+
+#endif // STREAM_FRAME_STORE_H
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "StreamRunningRMS.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace essentiawrapper {
+
+StreamRunningRMS::StreamRunningRMS() : Algorithm(), _frameSize(0), _hopSize(0)
+{
+    declareInput(_signal, 1, "signal", "the input signal");
+    declareOutput(_rms, 1, "rms", "the RMS of every frame");
+}
+
+void StreamRunningRMS::declareParameters()
+{
+    declareParameter("frameSize", "the size of the frames [samples]", "[1,inf)", 11025);
+    declareParameter("hopSize", "the number of samples between two frames", "[1,inf)", 256);
+}
+
+void StreamRunningRMS::configure()
+{
+    _frameSize = parameter("frameSize").toInt();
+    _hopSize = parameter("hopSize").toInt();
+
+    reset();
+}
+
+void StreamRunningRMS::reset()
+{
+    Algorithm::reset();
+
+    _window.assign(_frameSize, 0.0);
+    _windowIndex = 0;
+    _sumSquares = 0.0;
+
+    // the first frame is centered on the first sample, as in FrameCutter
+    _consumed = 0;
+    _position = 0;
+    _nextFrameEnd = _frameSize - (_frameSize + 1) / 2;
+    _frames = 0;
+
+    _signal.setAcquireSize(1);
+    _signal.setReleaseSize(1);
+    _rms.setAcquireSize(1);
+    _rms.setReleaseSize(1);
+}
+
+void StreamRunningRMS::push(Real sample)
+{
+    Real &oldest = _window[_windowIndex];
+    _sumSquares += double(sample) * sample - double(oldest) * oldest;
+    oldest = sample;
+
+    if (++_windowIndex == _frameSize) _windowIndex = 0;
+    ++_position;
+}
+
+Real StreamRunningRMS::frameRms() const
+{
+    // the running sum can drift slightly below zero on silence
+    return Real(sqrt(max(_sumSquares, 0.0) / _frameSize));
+}
+
+streaming::AlgorithmStatus StreamRunningRMS::process()
+{
+    if (!shouldStop())
+    {
+        // read exactly up to the end of the next frame
+        int needed = int(_nextFrameEnd - _position);
+        _signal.setAcquireSize(needed);
+        _signal.setReleaseSize(needed);
+        _rms.setAcquireSize(1);
+        _rms.setReleaseSize(1);
+
+        streaming::AlgorithmStatus status = acquireData();
+
+        if (status == streaming::OK)
+        {
+            for (Real sample : _signal.tokens()) push(sample);
+            _consumed += needed;
+
+            _rms.firstToken() = frameRms();
+            _nextFrameEnd += _hopSize;
+            ++_frames;
+
+            releaseData();
+            return streaming::OK;
+        }
+
+        if (status == streaming::NO_OUTPUT) return streaming::NO_OUTPUT;
+        if (!shouldStop()) return streaming::NO_INPUT;
+    }
+
+    // end of the stream, the frames starting before the end of the signal are
+    // completed with zeros
+    int available = _signal.available();
+    long long length = _consumed + available;
+    long long frames = 0;
+    if (length > 0) frames = (length + (_frameSize + 1) / 2 + _hopSize - 1) / _hopSize;
+    int remaining = int(frames - _frames);
+
+    if (available == 0 && remaining <= 0) return streaming::NO_INPUT;
+
+    _signal.setAcquireSize(available);
+    _signal.setReleaseSize(available);
+    _rms.setAcquireSize(max(remaining, 0));
+    _rms.setReleaseSize(max(remaining, 0));
+
+    if (acquireData() != streaming::OK) return streaming::NO_OUTPUT;
+
+    for (Real sample : _signal.tokens()) push(sample);
+    _consumed += available;
+
+    vector<Real> &rms = _rms.tokens();
+    for (int i = 0; i < remaining; ++i)
+    {
+        while (_position < _nextFrameEnd) push(0.0);
+
+        rms[i] = frameRms();
+        _nextFrameEnd += _hopSize;
+        ++_frames;
+    }
+
+    releaseData();
+    return streaming::OK;
+}
+
+} // namespace essentiawrapper
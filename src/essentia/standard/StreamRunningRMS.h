@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef STREAM_RUNNING_RMS_H
+#define STREAM_RUNNING_RMS_H
+
+#include <vector>
+
+#include "streaming/streamingalgorithm.h"
+#include "types.h"
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+/**
+ * @brief Computes the RMS of the frames FrameCutter would cut from the signal
+ * (centered on the first sample, zero padded, until a frame starts past the
+ * end) from a running sum of squares, so every sample is added and removed
+ * once instead of once per frame it belongs to.
+ */
+class StreamRunningRMS : public streaming::Algorithm
+{
+protected:
+
+    streaming::Sink<Real> _signal;
+    streaming::Source<Real> _rms;
+
+    int _frameSize;
+    int _hopSize;
+
+    vector<Real> _window; // the last frameSize samples, circular
+    int _windowIndex;
+    double _sumSquares;
+
+    long long _consumed;     // samples read from the input
+    long long _position;     // samples pushed, including the padding at the end
+    long long _nextFrameEnd; // position where the next frame is complete
+    long long _frames;       // frames output
+
+    void push(Real sample);
+    Real frameRms() const;
+
+public:
+    StreamRunningRMS();
+    virtual ~StreamRunningRMS() = default;
+
+    virtual void declareParameters() override;
+    virtual void configure() override;
+    virtual streaming::AlgorithmStatus process() override;
+    virtual void reset() override;
+
+};
+
+} // namespace essentiawrapper
+
+#endif // STREAM_RUNNING_RMS_H
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "StreamTonalPeaks.h"
+
+#include <algorithm>
+
+namespace essentiawrapper {
+
+const size_t TonalPeaks::chunkPeaks;
+
+void TonalPeaks::addFrame(size_t peaks)
+{
+    if (_frequencies.empty() || _used + peaks > _frequencies.back().size())
+    {
+        // a frame never spans two chunks, a larger frame gets its own
+        size_t size = max(chunkPeaks, peaks);
+        _frequencies.push_back(HostVector<Real>(size));
+        _magnitudes.push_back(HostVector<Real>(size));
+        _used = 0;
+    }
+
+    Frame frame = { _frequencies.size() - 1, _used, _used + peaks };
+    _frames.push_back(frame);
+    _used += peaks;
+}
+
+StreamTonalPeaksWriter::StreamTonalPeaksWriter(TonalPeaks *peaks) : Algorithm(), _peaks(peaks)
+{
+    setName("tonal_peaks_writer");
+
+    declareInput(_frequencies, 1, "frequencies", "the peak frequencies of a frame [Hz]");
+    declareInput(_magnitudes, 1, "magnitudes", "the peak magnitudes of a frame");
+}
+
+streaming::AlgorithmStatus StreamTonalPeaksWriter::process()
+{
+    streaming::AlgorithmStatus status = acquireData();
+    if (status != streaming::OK) return status;
+
+    const vector<Real> &frequencies = _frequencies.firstToken();
+    const vector<Real> &magnitudes = _magnitudes.firstToken();
+
+    // the tonal descriptors sum the peaks in the order SpectralPeaks gives
+    // them with orderBy = magnitude, store them the same way
+    _order.resize(magnitudes.size());
+    for (size_t i = 0; i < _order.size(); ++i) _order[i] = i;
+    sort(_order.begin(), _order.end(), [&](size_t a, size_t b)
+    {
+        return magnitudes[a] > magnitudes[b];
+    });
+
+    size_t frame = _peaks->frames();
+    _peaks->addFrame(_order.size());
+    Real *storedFrequencies = _peaks->frequencies(frame);
+    Real *storedMagnitudes = _peaks->magnitudes(frame);
+    for (size_t i = 0; i < _order.size(); ++i)
+    {
+        storedFrequencies[i] = frequencies[_order[i]];
+        storedMagnitudes[i] = magnitudes[_order[i]];
+    }
+
+    releaseData();
+
+    return streaming::OK;
+}
+
+StreamTonalPeaksReader::StreamTonalPeaksReader(const TonalPeaks *peaks) : Algorithm(), _peaks(peaks), _frame(0)
+{
+    setName("tonal_peaks_reader");
+
+    declareOutput(_frequencies, 1, "frequencies", "the peak frequencies of a frame [Hz]");
+    declareOutput(_magnitudes, 1, "magnitudes", "the peak magnitudes of a frame");
+}
+
+bool StreamTonalPeaksReader::shouldStop() const
+{
+    return _frame >= _peaks->frames();
+}
+
+streaming::AlgorithmStatus StreamTonalPeaksReader::process()
+{
+    if (shouldStop()) return streaming::PASS;
+
+    streaming::AlgorithmStatus status = acquireData();
+    if (status != streaming::OK)
+    {
+        if (status == streaming::NO_OUTPUT)
+        {
+            throw EssentiaException("StreamTonalPeaksReader: internal error: output buffer full");
+        }
+        return streaming::NO_INPUT;
+    }
+
+    size_t peaks = _peaks->peaks(_frame);
+    const Real *frequencies = _peaks->frequencies(_frame);
+    const Real *magnitudes = _peaks->magnitudes(_frame);
+
+    _frequencies.firstToken().assign(frequencies, frequencies + peaks);
+    _magnitudes.firstToken().assign(magnitudes, magnitudes + peaks);
+    ++_frame;
+
+    releaseData();
+
+    return streaming::OK;
+}
+
+void StreamTonalPeaksReader::reset()
+{
+    Algorithm::reset();
+    _frame = 0;
+}
+
+} // namespace essentiawrapper
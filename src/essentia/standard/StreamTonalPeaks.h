@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef STREAM_TONAL_PEAKS_H
+#define STREAM_TONAL_PEAKS_H
+
+#include <vector>
+
+#include "../HostAllocator.h"
+#include "streaming/streamingalgorithm.h"
+#include "types.h"
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+/**
+ * @brief The spectral peaks of the tonal frames, recorded by the low level
+ * pass so the tonal descriptors can be computed without decoding the audio
+ * again. The peaks of a frame are ordered by descending magnitude.
+ *
+ * The peaks are kept in chunks taken from the arena of the analysis. The
+ * arena does not reuse freed memory, so the chunks are never grown: a frame
+ * that does not fit in the last chunk starts a new one.
+ */
+class TonalPeaks
+{
+public:
+    static const size_t chunkPeaks = 16384;
+
+    TonalPeaks() : _used(0) {}
+
+    /**
+     * @brief Adds a frame of the given number of peaks, to be filled through
+     * frequencies() and magnitudes().
+     */
+    void addFrame(size_t peaks);
+
+    // the memory of the chunks is kept by the arena of the analysis
+    void clear() { _frequencies.clear(); _magnitudes.clear(); _frames.clear(); _used = 0; }
+
+    size_t frames() const { return _frames.size(); }
+    size_t peaks(size_t frame) const { return _frames[frame].end - _frames[frame].begin; }
+
+    Real *frequencies(size_t frame) { return &_frequencies[_frames[frame].chunk][_frames[frame].begin]; }
+    Real *magnitudes(size_t frame) { return &_magnitudes[_frames[frame].chunk][_frames[frame].begin]; }
+    const Real *frequencies(size_t frame) const { return &_frequencies[_frames[frame].chunk][_frames[frame].begin]; }
+    const Real *magnitudes(size_t frame) const { return &_magnitudes[_frames[frame].chunk][_frames[frame].begin]; }
+
+private:
+    struct Frame
+    {
+        size_t chunk;
+        size_t begin;
+        size_t end;
+    };
+
+    vector<HostVector<Real> > _frequencies;
+    vector<HostVector<Real> > _magnitudes;
+    vector<Frame> _frames;
+    size_t _used; // peaks stored in the last chunk
+};
+
+/**
+ * @brief Appends the peaks of every frame to a TonalPeaks store.
+ */
+class StreamTonalPeaksWriter : public streaming::Algorithm
+{
+protected:
+
+    streaming::Sink<vector<Real> > _frequencies;
+    streaming::Sink<vector<Real> > _magnitudes;
+
+    TonalPeaks *_peaks;
+
+    vector<size_t> _order;
+
+public:
+    StreamTonalPeaksWriter(TonalPeaks *peaks);
+    virtual ~StreamTonalPeaksWriter() = default;
+
+    virtual void declareParameters() override {}
+    virtual streaming::AlgorithmStatus process() override;
+
+};
+
+/**
+ * @brief Streams the frames of a TonalPeaks store, the root of the tonal
+ * pass network.
+ */
+class StreamTonalPeaksReader : public streaming::Algorithm
+{
+protected:
+
+    streaming::Source<vector<Real> > _frequencies;
+    streaming::Source<vector<Real> > _magnitudes;
+
+    const TonalPeaks *_peaks;
+    size_t _frame;
+
+public:
+    StreamTonalPeaksReader(const TonalPeaks *peaks);
+    virtual ~StreamTonalPeaksReader() = default;
+
+    using streaming::Algorithm::shouldStop;
+    virtual bool shouldStop() const override;
+
+    virtual void declareParameters() override {}
+    virtual streaming::AlgorithmStatus process() override;
+    virtual void reset() override;
+
+};
+
+} // namespace essentiawrapper
+
+#endif // STREAM_TONAL_PEAKS_H
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "TonalHPCP.h"
+
+#include "algorithmfactory.h"
+#include "essentiamath.h"
+
+#include <cmath>
+
+namespace essentiawrapper {
+
+namespace {
+
+// same tolerance as the harmonic table of HPCP
+const Real harmonicPrecision = 1e-4;
+
+}
+
+const char *TonalHPCP::name = "TonalHPCP";
+const char *TonalHPCP::category = "Tonal";
+const char *TonalHPCP::description = "Computes the key, chord and high resolution HPCPs of the tonal descriptors in one pass over the spectral peaks.";
+
+TonalHPCP::TonalHPCP()
+{
+    declareInput(_frequencies, "frequencies", "the frequencies of the spectral peaks [Hz]");
+    declareInput(_magnitudes, "magnitudes", "the magnitudes of the spectral peaks");
+    declareOutput(_hpcpKey, "hpcpKey", "the HPCP for the key estimation");
+    declareOutput(_hpcpChord, "hpcpChord", "the HPCP for the chords estimation");
+    declareOutput(_hpcpHighRes, "hpcpHighRes", "the high resolution HPCP for the tuning system features");
+}
+
+void TonalHPCP::declareParameters()
+{
+    declareParameter("referenceFrequency", "the reference frequency for semitone index calculation, corresponding to A3 [Hz]", "(0,inf)", 440.0);
+    declareParameter("minFrequency", "the minimum frequency that contributes to the HPCPs [Hz]", "(0,inf)", 40.0);
+    declareParameter("maxFrequency", "the maximum frequency that contributes to the HPCPs [Hz]", "(0,inf)", 5000.0);
+    declareParameter("splitFrequency", "the split frequency of the low and high bands of the chord and high resolution HPCPs [Hz]", "(0,inf)", 500.0);
+    declareParameter("harmonics", "the number of harmonics of the chord and high resolution HPCPs", "[0,inf)", 8);
+    declareParameter("keySize", "the size of the key HPCP, a multiple of 12", "[12,inf)", 36);
+    declareParameter("keyWindowSize", "the size of the squared cosine window of the key HPCP [semitones]", "(0,12]", 4.0 / 3.0);
+    declareParameter("chordSize", "the size of the chord HPCP, a multiple of 12", "[12,inf)", 36);
+    declareParameter("highResSize", "the size of the high resolution HPCP, a multiple of 12", "[12,inf)", 120);
+    declareParameter("windowSize", "the size of the cosine window of the chord and high resolution HPCPs [semitones]", "(0,12]", 0.5);
+}
+
+void TonalHPCP::configure()
+{
+    _referenceFrequency = parameter("referenceFrequency").toReal();
+    _minFrequency = parameter("minFrequency").toReal();
+    _maxFrequency = parameter("maxFrequency").toReal();
+    _splitFrequency = parameter("splitFrequency").toReal();
+
+    if (_minFrequency >= _maxFrequency)
+    {
+        throw EssentiaException("TonalHPCP: minFrequency must be lower than maxFrequency");
+    }
+    if (_splitFrequency - _minFrequency < 200.0 || _maxFrequency - _splitFrequency < 200.0)
+    {
+        throw EssentiaException("TonalHPCP: splitFrequency must be at least 200 Hz away from minFrequency and maxFrequency");
+    }
+
+    initProfile(_key, parameter("keySize").toInt(), parameter("keyWindowSize").toReal(), true);
+    initProfile(_chord, parameter("chordSize").toInt(), parameter("windowSize").toReal(), false);
+    initProfile(_highRes, parameter("highResSize").toInt(), parameter("windowSize").toReal(), false);
+
+    // the pitch classes of the harmonics, harmonics falling on the same pitch
+    // class add their weights as in HPCP
+    int harmonics = parameter("harmonics").toInt();
+    _harmonics.clear();
+    for (int i = 0; i <= harmonics; ++i)
+    {
+        Real semitone = 12.0 * log2(i + 1.0);
+        Real octweight = max(1.0, (semitone / 12.0) * 0.5);
+
+        while (semitone >= 12.0 - harmonicPrecision)
+        {
+            semitone -= 12.0;
+        }
+
+        vector<Harmonic>::iterator it = _harmonics.begin();
+        while (it != _harmonics.end() && fabs(it->octaves * 12.0 - semitone) >= harmonicPrecision)
+        {
+            ++it;
+        }
+
+        if (it == _harmonics.end())
+        {
+            Harmonic h;
+            h.octaves = semitone / 12.0;
+            h.strength = 1.0 / octweight;
+            _harmonics.push_back(h);
+        }
+        else
+        {
+            it->strength += 1.0 / octweight;
+        }
+    }
+
+    // the contributions are weighted with the squared harmonic strength
+    for (Harmonic &h : _harmonics)
+    {
+        h.strength *= h.strength;
+    }
+}
+
+void TonalHPCP::initProfile(Profile &profile, int size, Real windowSize, bool squared)
+{
+    if (size % 12 != 0)
+    {
+        throw EssentiaException("TonalHPCP: the HPCP sizes must be a multiple of 12");
+    }
+
+    int resolution = size / 12;
+    if (windowSize * resolution < 1.0)
+    {
+        throw EssentiaException("TonalHPCP: the windows must cover at least one bin");
+    }
+
+    profile.size = size;
+    profile.halfWindow = resolution * windowSize / 2.0;
+    profile.distanceScale = 1.0 / (resolution * windowSize);
+    profile.squared = squared;
+    profile.low.assign(size, 0.0);
+    profile.high.assign(size, 0.0);
+}
+
+// adds the window centered at the pitch class of the octave position
+void TonalHPCP::addContribution(Profile &profile, vector<Real> &hpcp, Real octaves, Real weight) const
+{
+    int size = profile.size;
+    Real binF = octaves * size;
+
+    int leftBin = (int)ceil(binF - profile.halfWindow);
+    int rightBin = (int)floor(binF + profile.halfWindow);
+
+    int wrapped = leftBin % size;
+    if (wrapped < 0) wrapped += size;
+
+    for (int i = leftBin; i <= rightBin; ++i)
+    {
+        Real w = cos(M_PI * fabs(binF - (Real)i) * profile.distanceScale);
+        if (profile.squared) w *= w;
+
+        hpcp[wrapped] += w * weight;
+        if (++wrapped == size) wrapped = 0;
+    }
+}
+
+void TonalHPCP::finishBandPreset(Profile &profile, vector<Real> &hpcp) const
+{
+    normalize(profile.low);
+    normalize(profile.high);
+
+    hpcp.resize(profile.size);
+    for (int i = 0; i < profile.size; ++i)
+    {
+        hpcp[i] = profile.low[i] + profile.high[i];
+    }
+
+    normalize(hpcp);
+
+    // nonLinear
+    for (Real &value : hpcp)
+    {
+        value = sin(value * M_PI * 0.5);
+        value *= value;
+        if (value < 1e-6) value = 0.0;
+    }
+}
+
+void TonalHPCP::compute()
+{
+    const vector<Real> &frequencies = _frequencies.get();
+    const vector<Real> &magnitudes = _magnitudes.get();
+
+    if (magnitudes.size() != frequencies.size())
+    {
+        throw EssentiaException("TonalHPCP: Frequency and magnitude input vectors are not of equal size");
+    }
+
+    fill(_key.low.begin(), _key.low.end(), (Real)0.0);
+    fill(_chord.low.begin(), _chord.low.end(), (Real)0.0);
+    fill(_chord.high.begin(), _chord.high.end(), (Real)0.0);
+    fill(_highRes.low.begin(), _highRes.low.end(), (Real)0.0);
+    fill(_highRes.high.begin(), _highRes.high.end(), (Real)0.0);
+
+    for (size_t p = 0; p < frequencies.size(); ++p)
+    {
+        Real freq = frequencies[p];
+        if (freq < _minFrequency || freq > _maxFrequency) continue;
+
+        Real energy = magnitudes[p] * magnitudes[p];
+        Real octaves = log2(freq / _referenceFrequency);
+
+        // the key profile has no harmonics and no bands
+        addContribution(_key, _key.low, octaves, energy);
+
+        bool low = freq < _splitFrequency;
+        for (const Harmonic &h : _harmonics)
+        {
+            Real weight = energy * h.strength;
+            addContribution(_chord, low ? _chord.low : _chord.high, octaves - h.octaves, weight);
+            addContribution(_highRes, low ? _highRes.low : _highRes.high, octaves - h.octaves, weight);
+        }
+    }
+
+    vector<Real> &hpcpKey = _hpcpKey.get();
+    hpcpKey = _key.low;
+    normalize(hpcpKey);
+
+    finishBandPreset(_chord, _hpcpChord.get());
+    finishBandPreset(_highRes, _hpcpHighRes.get());
+}
+
+StreamTonalHPCP::StreamTonalHPCP()
+{
+    declareAlgorithm("TonalHPCP");
+    declareInput(_frequencies, streaming::TOKEN, "frequencies");
+    declareInput(_magnitudes, streaming::TOKEN, "magnitudes");
+    declareOutput(_hpcpKey, streaming::TOKEN, "hpcpKey");
+    declareOutput(_hpcpChord, streaming::TOKEN, "hpcpChord");
+    declareOutput(_hpcpHighRes, streaming::TOKEN, "hpcpHighRes");
+}
+
+} // namespace essentiawrapper
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef TONAL_HPCP_H
+#define TONAL_HPCP_H
+
+#include "algorithm.h"
+#include "streaming/streamingalgorithmwrapper.h"
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+/**
+ * @brief The TonalHPCP class computes the three HPCPs of the tonal descriptors
+ * in one walk over the spectral peaks of a frame.
+ *
+ * The profiles are the ones of three separate HPCP algorithms:
+ *  - hpcpKey: keySize bins, no harmonics, squaredCosine window of keyWindowSize
+ *  - hpcpChord, hpcpHighRes: chordSize and highResSize bins, harmonics,
+ *    bandPreset split at splitFrequency, cosine window of windowSize, nonLinear
+ * The log frequency of a peak and the positions of its harmonics are computed
+ * once and shared by all profiles.
+ */
+class TonalHPCP : public standard::Algorithm
+{
+protected:
+    standard::Input<vector<Real> > _frequencies;
+    standard::Input<vector<Real> > _magnitudes;
+    standard::Output<vector<Real> > _hpcpKey;
+    standard::Output<vector<Real> > _hpcpChord;
+    standard::Output<vector<Real> > _hpcpHighRes;
+
+    struct Harmonic
+    {
+        Real octaves;  // offset of the harmonic pitch class [octaves]
+        Real strength; // squared weight of the harmonic
+    };
+
+    // one profile, summed over the peaks
+    struct Profile
+    {
+        int size;
+        Real halfWindow;   // half of the window [bins]
+        Real distanceScale; // bins to normalized window distance
+        bool squared;
+        vector<Real> low;  // below splitFrequency, or all of them without bandPreset
+        vector<Real> high;
+    };
+
+    Real _referenceFrequency;
+    Real _minFrequency;
+    Real _maxFrequency;
+    Real _splitFrequency;
+
+    vector<Harmonic> _harmonics;
+
+    Profile _key;
+    Profile _chord;
+    Profile _highRes;
+
+    void initProfile(Profile &profile, int size, Real windowSize, bool squared);
+    void addContribution(Profile &profile, vector<Real> &hpcp, Real octaves, Real weight) const;
+    void finishBandPreset(Profile &profile, vector<Real> &hpcp) const;
+
+public:
+    TonalHPCP();
+    virtual ~TonalHPCP() = default;
+
+    virtual void declareParameters() override;
+    virtual void configure() override;
+    virtual void compute() override;
+
+    static const char *name;
+    static const char *category;
+    static const char *description;
+
+};
+
+class StreamTonalHPCP : public streaming::StreamingAlgorithmWrapper
+{
+protected:
+    streaming::Sink<vector<Real> > _frequencies;
+    streaming::Sink<vector<Real> > _magnitudes;
+    streaming::Source<vector<Real> > _hpcpKey;
+    streaming::Source<vector<Real> > _hpcpChord;
+    streaming::Source<vector<Real> > _hpcpHighRes;
+
+public:
+    StreamTonalHPCP();
+
+};
+
+} // namespace essentiawrapper
+
+#endif // TONAL_HPCP_H
@@ -0,0 +1,516 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "BinaryOutput.h"
+#include "Checksum.h"
+#include "essentia.h"
+#include "essentia_binary_reader.h"
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+
+
+using namespace standard;
+
+namespace essentiawrapper {
+
+BinaryOutput::BinaryOutput()
+{
+    declareInput(_pool, "pool", "Pool to serialize into a binary result file");
+}
+
+void BinaryOutput::declareParameters()
+{
+    declareParameter("filename", "output filename (use '-' to emit to stdout)", "", "-");
+    declareParameter("writeVersion", "whether to write the essentia version to the output file", "", true);
+    declareParameter("doubleCheck", "whether to double-check if the file has been correctly written to the disk", "", false);
+}
+
+void BinaryOutput::configure()
+{
+    _filename = parameter("filename").toString();
+    _doubleCheck = parameter("doubleCheck").toBool();
+    _writeVersion = parameter("writeVersion").toBool();
+
+    if (_filename == "") throw EssentiaException("please provide a valid filename");
+}
+
+namespace {
+
+static_assert(sizeof(Real) == 4, "the binary output writes the reals as 32 bit floats");
+
+// A descriptor of the pool with its place in the file. The values are not
+// copied, they are written from the pool maps.
+struct BinaryEntry
+{
+    enum Kind
+    {
+        SingleReal,
+        VectorReal,
+        VectorVectorReal,
+        SingleString,
+        VectorString,
+        VectorVectorString,
+        VectorArray2DReal,
+        VectorStereoSample
+    };
+
+    const string *name;
+    Kind kind;
+    const void *value;
+
+    uint32_t type;
+    uint32_t rank;
+    uint32_t flags;
+    uint64_t shape[3];
+    uint64_t count;       // the values of all rows
+    uint64_t stringBytes; // the strings with their terminating nulls
+
+    uint64_t nameOffset;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+bool littleEndianHost()
+{
+    const uint16_t value = 1;
+    return *reinterpret_cast<const uint8_t *>(&value) == 1;
+}
+
+// Writes the numbers little endian and keeps track of the offset in the file.
+class LittleEndianWriter
+{
+public:
+    explicit LittleEndianWriter(ostream *out) : _out(out), _offset(0), _swap(!littleEndianHost()) {}
+
+    uint64_t offset() const { return _offset; }
+
+    void bytes(const void *data, size_t size)
+    {
+        _out->write(static_cast<const char *>(data), size);
+        _offset += size;
+    }
+
+    void u32(uint32_t value)
+    {
+        if (_swap) value = swap32(value);
+        bytes(&value, sizeof(value));
+    }
+
+    void u64(uint64_t value)
+    {
+        if (_swap) value = (uint64_t(swap32(uint32_t(value))) << 32) | swap32(uint32_t(value >> 32));
+        bytes(&value, sizeof(value));
+    }
+
+    void reals(const Real *values, size_t size)
+    {
+        if (!_swap)
+        {
+            bytes(values, size * sizeof(Real));
+            return;
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            uint32_t value;
+            memcpy(&value, &values[i], sizeof(value));
+            u32(value);
+        }
+    }
+
+    void padTo(uint64_t offset)
+    {
+        static const char zeros[ESSENTIA_BINARY_ALIGNMENT] = {};
+        while (_offset < offset)
+        {
+            bytes(zeros, size_t(min<uint64_t>(offset - _offset, sizeof(zeros))));
+        }
+    }
+
+private:
+    ostream *_out;
+    uint64_t _offset;
+    bool _swap;
+
+    static uint32_t swap32(uint32_t value)
+    {
+        return (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+    }
+};
+
+uint64_t align(uint64_t offset)
+{
+    return essentia_binary_align(offset);
+}
+
+// Sets the shape of a vector of rows: a matrix when all the rows have the
+// same length, otherwise ragged rows.
+template <typename Row, typename Length>
+void describeRows(BinaryEntry &entry, const vector<Row> &rows, Length length)
+{
+    entry.rank = 2;
+    entry.shape[0] = rows.size();
+    entry.count = 0;
+
+    bool rectangular = true;
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        entry.count += length(rows[i]);
+        if (length(rows[i]) != length(rows[0])) rectangular = false;
+    }
+
+    if (rectangular) entry.shape[1] = rows.empty() ? 0 : length(rows[0]);
+    else entry.flags |= ESSENTIA_BINARY_RAGGED;
+}
+
+template <typename Visitor>
+void visitStrings(const BinaryEntry &entry, Visitor visit)
+{
+    switch (entry.kind)
+    {
+    case BinaryEntry::SingleString:
+        visit(*static_cast<const string *>(entry.value));
+        break;
+    case BinaryEntry::VectorString:
+        for (const string &s : *static_cast<const vector<string> *>(entry.value)) visit(s);
+        break;
+    case BinaryEntry::VectorVectorString:
+        for (const vector<string> &row : *static_cast<const vector<vector<string> > *>(entry.value))
+        {
+            for (const string &s : row) visit(s);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void describe(BinaryEntry &entry)
+{
+    entry.type = ESSENTIA_BINARY_REAL;
+    entry.rank = 0;
+    entry.flags = 0;
+    entry.shape[0] = entry.shape[1] = entry.shape[2] = 0;
+    entry.count = 1;
+    entry.stringBytes = 0;
+
+    switch (entry.kind)
+    {
+    case BinaryEntry::SingleReal:
+        break;
+    case BinaryEntry::VectorReal:
+        entry.rank = 1;
+        entry.count = entry.shape[0] = static_cast<const vector<Real> *>(entry.value)->size();
+        break;
+    case BinaryEntry::VectorVectorReal:
+        describeRows(entry, *static_cast<const vector<vector<Real> > *>(entry.value),
+                     [](const vector<Real> &row) { return uint64_t(row.size()); });
+        break;
+    case BinaryEntry::SingleString:
+        entry.type = ESSENTIA_BINARY_STRING;
+        break;
+    case BinaryEntry::VectorString:
+        entry.type = ESSENTIA_BINARY_STRING;
+        entry.rank = 1;
+        entry.count = entry.shape[0] = static_cast<const vector<string> *>(entry.value)->size();
+        break;
+    case BinaryEntry::VectorVectorString:
+        entry.type = ESSENTIA_BINARY_STRING;
+        describeRows(entry, *static_cast<const vector<vector<string> > *>(entry.value),
+                     [](const vector<string> &row) { return uint64_t(row.size()); });
+        break;
+    case BinaryEntry::VectorArray2DReal:
+    {
+        // matrices of different sizes are written as ragged rows, one
+        // flattened matrix per row
+        const vector<TNT::Array2D<Real> > &matrices = *static_cast<const vector<TNT::Array2D<Real> > *>(entry.value);
+        describeRows(entry, matrices, [](const TNT::Array2D<Real> &m) { return uint64_t(m.dim1()) * uint64_t(m.dim2()); });
+
+        bool sameShape = true;
+        for (size_t i = 1; i < matrices.size(); ++i)
+        {
+            if (matrices[i].dim1() != matrices[0].dim1() || matrices[i].dim2() != matrices[0].dim2()) sameShape = false;
+        }
+        if (sameShape && !matrices.empty())
+        {
+            entry.rank = 3;
+            entry.flags = 0;
+            entry.shape[1] = matrices[0].dim1();
+            entry.shape[2] = matrices[0].dim2();
+        }
+        break;
+    }
+    case BinaryEntry::VectorStereoSample:
+        entry.rank = 2;
+        entry.shape[0] = static_cast<const vector<StereoSample> *>(entry.value)->size();
+        entry.shape[1] = 2;
+        entry.count = entry.shape[0] * 2;
+        break;
+    }
+
+    visitStrings(entry, [&entry](const string &s) { entry.stringBytes += s.size() + 1; });
+
+    // the row offsets, then the values
+    uint64_t size = 0;
+    if (entry.flags & ESSENTIA_BINARY_RAGGED) size = align((entry.shape[0] + 1) * sizeof(uint64_t));
+
+    if (entry.type == ESSENTIA_BINARY_REAL) size += entry.count * sizeof(Real);
+    else size += align((entry.count + 1) * sizeof(uint64_t)) + entry.stringBytes;
+
+    entry.dataSize = size;
+}
+
+void addBinaryEntry(vector<BinaryEntry> &entries, const string &name, BinaryEntry::Kind kind, const void *value)
+{
+    BinaryEntry entry;
+    entry.name = &name;
+    entry.kind = kind;
+    entry.value = value;
+    describe(entry);
+    entries.push_back(entry);
+}
+
+void collectBinaryEntries(const Pool &p, vector<BinaryEntry> &entries)
+{
+#define COLLECT_ENTRIES_MACRO(type, tname, entryKind)                          \
+  for (map<string, type >::const_iterator it = p.get##tname##Pool().begin();   \
+       it != p.get##tname##Pool().end(); ++it) {                               \
+    addBinaryEntry(entries, it->first, BinaryEntry::entryKind, &it->second);   \
+  }
+
+    COLLECT_ENTRIES_MACRO(Real, SingleReal, SingleReal);
+    COLLECT_ENTRIES_MACRO(vector<Real>, Real, VectorReal);
+    COLLECT_ENTRIES_MACRO(vector<Real>, SingleVectorReal, VectorReal);
+    COLLECT_ENTRIES_MACRO(vector<vector<Real> >, VectorReal, VectorVectorReal);
+
+    COLLECT_ENTRIES_MACRO(string, SingleString, SingleString);
+    COLLECT_ENTRIES_MACRO(vector<string>, String, VectorString);
+    COLLECT_ENTRIES_MACRO(vector<vector<string> >, VectorString, VectorVectorString);
+
+    COLLECT_ENTRIES_MACRO(vector<TNT::Array2D<Real> >, Array2DReal, VectorArray2DReal);
+    COLLECT_ENTRIES_MACRO(vector<StereoSample>, StereoSample, VectorStereoSample);
+
+#undef COLLECT_ENTRIES_MACRO
+}
+
+void writeRowOffsets(LittleEndianWriter &writer, const BinaryEntry &entry)
+{
+    uint64_t offset = 0;
+    writer.u64(offset);
+
+    switch (entry.kind)
+    {
+    case BinaryEntry::VectorVectorReal:
+        for (const vector<Real> &row : *static_cast<const vector<vector<Real> > *>(entry.value))
+        {
+            writer.u64(offset += row.size());
+        }
+        break;
+    case BinaryEntry::VectorVectorString:
+        for (const vector<string> &row : *static_cast<const vector<vector<string> > *>(entry.value))
+        {
+            writer.u64(offset += row.size());
+        }
+        break;
+    case BinaryEntry::VectorArray2DReal:
+        for (const TNT::Array2D<Real> &m : *static_cast<const vector<TNT::Array2D<Real> > *>(entry.value))
+        {
+            writer.u64(offset += uint64_t(m.dim1()) * uint64_t(m.dim2()));
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void writeReals(LittleEndianWriter &writer, const BinaryEntry &entry)
+{
+    switch (entry.kind)
+    {
+    case BinaryEntry::SingleReal:
+        writer.reals(static_cast<const Real *>(entry.value), 1);
+        break;
+    case BinaryEntry::VectorReal:
+    {
+        const vector<Real> &values = *static_cast<const vector<Real> *>(entry.value);
+        writer.reals(values.data(), values.size());
+        break;
+    }
+    case BinaryEntry::VectorVectorReal:
+        for (const vector<Real> &row : *static_cast<const vector<vector<Real> > *>(entry.value))
+        {
+            writer.reals(row.data(), row.size());
+        }
+        break;
+    case BinaryEntry::VectorArray2DReal:
+        for (const TNT::Array2D<Real> &m : *static_cast<const vector<TNT::Array2D<Real> > *>(entry.value))
+        {
+            for (int i = 0; i < m.dim1(); ++i) writer.reals(m[i], m.dim2());
+        }
+        break;
+    case BinaryEntry::VectorStereoSample:
+        for (const StereoSample &sample : *static_cast<const vector<StereoSample> *>(entry.value))
+        {
+            Real values[2] = { sample.left(), sample.right() };
+            writer.reals(values, 2);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void writeStrings(LittleEndianWriter &writer, const BinaryEntry &entry)
+{
+    uint64_t offset = 0;
+    writer.u64(offset);
+    visitStrings(entry, [&writer, &offset](const string &s) { writer.u64(offset += s.size() + 1); });
+
+    writer.padTo(align(writer.offset()));
+    visitStrings(entry, [&writer](const string &s) { writer.bytes(s.c_str(), s.size() + 1); });
+}
+
+// Writes the header, the index sorted on the names, the names and the
+// aligned data of every entry.
+void writeBinaryEntries(vector<BinaryEntry> &entries, ostream *out)
+{
+    // the readers look the names up with a binary search
+    sort(entries.begin(), entries.end(), [](const BinaryEntry &a, const BinaryEntry &b)
+    {
+        return *a.name < *b.name;
+    });
+
+    uint64_t indexOffset = ESSENTIA_BINARY_HEADER_SIZE;
+    uint64_t namesOffset = indexOffset + entries.size() * ESSENTIA_BINARY_ENTRY_SIZE;
+    uint64_t offset = namesOffset;
+
+    for (BinaryEntry &entry : entries)
+    {
+        entry.nameOffset = offset;
+        offset += entry.name->size() + 1;
+    }
+    for (BinaryEntry &entry : entries)
+    {
+        entry.dataOffset = align(offset);
+        offset = entry.dataOffset + entry.dataSize;
+    }
+    uint64_t fileSize = offset;
+
+    LittleEndianWriter writer(out);
+
+    writer.bytes(essentia_binary_magic, sizeof(essentia_binary_magic));
+    writer.u32(ESSENTIA_BINARY_VERSION);
+    writer.u32(uint32_t(entries.size()));
+    writer.u64(indexOffset);
+    writer.u64(namesOffset);
+    writer.u64(fileSize);
+    writer.padTo(indexOffset);
+
+    for (const BinaryEntry &entry : entries)
+    {
+        writer.u64(entry.nameOffset);
+        writer.u32(uint32_t(entry.name->size()));
+        writer.u32(entry.type);
+        writer.u32(entry.rank);
+        writer.u32(entry.flags);
+        for (int i = 0; i < 3; ++i) writer.u64(entry.shape[i]);
+        writer.u64(entry.dataOffset);
+        writer.u64(entry.dataSize);
+    }
+
+    for (const BinaryEntry &entry : entries)
+    {
+        writer.bytes(entry.name->c_str(), entry.name->size() + 1);
+    }
+
+    for (const BinaryEntry &entry : entries)
+    {
+        writer.padTo(entry.dataOffset);
+
+        if (entry.flags & ESSENTIA_BINARY_RAGGED)
+        {
+            writeRowOffsets(writer, entry);
+            writer.padTo(align(writer.offset()));
+        }
+
+        if (entry.type == ESSENTIA_BINARY_REAL) writeReals(writer, entry);
+        else writeStrings(writer, entry);
+    }
+}
+
+}
+
+void BinaryOutput::outputToStream(ostream *out)
+{
+    const Pool &p = _pool.get();
+
+    vector<BinaryEntry> entries;
+
+    // add metadata.version.essentia to the values of the pool
+    const string versionName = "metadata.version.essentia";
+    const string version = essentia::version;
+    if (_writeVersion)
+    {
+        addBinaryEntry(entries, versionName, BinaryEntry::SingleString, &version);
+    }
+
+    collectBinaryEntries(p, entries);
+    writeBinaryEntries(entries, out);
+}
+
+void BinaryOutput::compute()
+{
+    if (_filename == "-")
+    {
+        outputToStream(&cout);
+    }
+    else if (!_doubleCheck)
+    {
+        ofstream out(_filename.c_str(), ios_base::out | ios_base::binary);
+        outputToStream(&out);
+        out.close();
+    }
+    else
+    {
+        ofstream file(_filename.c_str(), ios_base::out | ios_base::binary);
+        ChecksumBuffer checksum(file.rdbuf());
+        ostream out(&checksum);
+        outputToStream(&out);
+        out.flush();
+        file.close();
+
+        uint64_t hash;
+        uint64_t size;
+        if (!fileChecksum(_filename, ios_base::binary, hash, size))
+        {
+            throw EssentiaException("BinaryOutput: error when double-checking the output file; it doesn't look like it was written at all");
+        }
+
+        if (!out.good() || size != checksum.size() || hash != checksum.hash())
+        {
+            throw EssentiaException("BinaryOutput: error when double-checking the output file; it doesn't match the expected output");
+        }
+    }
+}
+
+} // namespace essentiawrapper
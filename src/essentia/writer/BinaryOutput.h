@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef BINARY_OUTPUT_H
+#define BINARY_OUTPUT_H
+
+#include "algorithm.h"
+#include "pool.h"
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+/**
+ * @brief Writes the pool to the binary result file described in
+ * essentia_binary_reader.h: an index of the descriptor names, types and
+ * shapes followed by the values, 64 byte aligned, to be mapped in memory by
+ * the consumers instead of parsing the JSON output.
+ */
+class BinaryOutput : public standard::Algorithm
+{
+
+protected:
+    standard::Input<Pool> _pool;
+    string _filename;
+    bool _doubleCheck;
+    bool _writeVersion;
+
+    void outputToStream(ostream *out);
+
+public:
+
+    BinaryOutput();
+    virtual ~BinaryOutput() = default;
+
+    virtual void declareParameters() override;
+    virtual void configure() override;
+    virtual void compute() override;
+
+};
+
+} // namespace essentiawrapper
+
+#endif // BINARY_OUTPUT_H
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "Checksum.h"
+
+#include <fstream>
+
+namespace essentiawrapper {
+
+uint64_t updateChecksum(uint64_t hash, const char *data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+ChecksumBuffer::int_type ChecksumBuffer::overflow(int_type c)
+{
+    if (!flushBuffer()) return traits_type::eof();
+    if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+    return c;
+}
+
+int ChecksumBuffer::sync()
+{
+    if (!flushBuffer()) return -1;
+    return _target->pubsync();
+}
+
+bool ChecksumBuffer::flushBuffer()
+{
+    streamsize pending = pptr() - pbase();
+    _hash = updateChecksum(_hash, pbase(), size_t(pending));
+    _size += uint64_t(pending);
+
+    bool written = _target->sputn(pbase(), pending) == pending;
+    setp(_buffer.data(), _buffer.data() + _buffer.size());
+    return written;
+}
+
+bool fileChecksum(const string &filename, ios_base::openmode mode, uint64_t &hash, uint64_t &size)
+{
+    ifstream f(filename.c_str(), ios_base::in | mode);
+    if (!f.good()) return false;
+
+    hash = checksumSeed;
+    size = 0;
+    vector<char> chunk(1 << 16);
+    while (f.read(chunk.data(), chunk.size()) || f.gcount() > 0)
+    {
+        hash = updateChecksum(hash, chunk.data(), size_t(f.gcount()));
+        size += uint64_t(f.gcount());
+    }
+    return true;
+}
+
+} // namespace essentiawrapper
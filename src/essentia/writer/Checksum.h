@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stdint.h>
+#include <ios>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace essentiawrapper {
+
+// FNV-1a, the checksum of the double check
+const uint64_t checksumSeed = 14695981039346656037ULL;
+
+uint64_t updateChecksum(uint64_t hash, const char *data, size_t size);
+
+/**
+ * @brief Stream buffer forwarding to the file and hashing the bytes on the
+ * way, so the written file can be checked without serializing the pool again.
+ */
+class ChecksumBuffer : public streambuf
+{
+public:
+    explicit ChecksumBuffer(streambuf *target) : _target(target), _hash(checksumSeed), _size(0), _buffer(1 << 16)
+    {
+        setp(_buffer.data(), _buffer.data() + _buffer.size());
+    }
+
+    uint64_t hash() const { return _hash; }
+    uint64_t size() const { return _size; }
+
+protected:
+    virtual int_type overflow(int_type c) override;
+    virtual int sync() override;
+
+private:
+    streambuf *_target;
+    uint64_t _hash;
+    uint64_t _size;
+    vector<char> _buffer;
+
+    bool flushBuffer();
+};
+
+/**
+ * @brief Reads back a written file in chunks and hashes it.
+ *
+ * The file must be opened in the mode it was written in, or otherwise the
+ * check fails on windows due to new lines.
+ *
+ * @return false if the file cannot be opened.
+ */
+bool fileChecksum(const string &filename, ios_base::openmode mode, uint64_t &hash, uint64_t &size);
+
+} // namespace essentiawrapper
+
+#endif // CHECKSUM_H
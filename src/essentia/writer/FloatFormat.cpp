@@ -0,0 +1,436 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "FloatFormat.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace essentiawrapper {
+
+namespace {
+
+// The float to decimal conversion of Ryu (Ulf Adams, PLDI 2018), for the
+// 32 bit floats only.
+
+const int mantissaBits = 23;
+const int exponentBits = 8;
+const int exponentBias = 127;
+
+const int pow5InvBitCount = 59;
+const int pow5BitCount = 61;
+
+const int pow5InvTableSize = 31;
+const int pow5TableSize = 47;
+
+// ceil(log2(5^e)), 1 for e = 0
+int32_t pow5bits(int32_t e)
+{
+    return int32_t((uint32_t(e) * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2^e))
+uint32_t log10Pow2(int32_t e)
+{
+    return (uint32_t(e) * 78913) >> 18;
+}
+
+// floor(log10(5^e))
+uint32_t log10Pow5(int32_t e)
+{
+    return (uint32_t(e) * 732923) >> 20;
+}
+
+// the 128 bit arithmetic needed to build the tables
+struct Uint128
+{
+    uint64_t hi;
+    uint64_t lo;
+
+    Uint128(uint64_t h = 0, uint64_t l = 0) : hi(h), lo(l) {}
+
+    void multiply5()
+    {
+        // x * 5 = (x << 2) + x
+        uint64_t lo4 = lo << 2;
+        uint64_t hi4 = (hi << 2) | (lo >> 62);
+        uint64_t sum = lo4 + lo;
+        hi = hi4 + hi + (sum < lo4 ? 1 : 0);
+        lo = sum;
+    }
+
+    void shiftLeft1()
+    {
+        hi = (hi << 1) | (lo >> 63);
+        lo <<= 1;
+    }
+
+    bool lessThan(const Uint128 &other) const
+    {
+        return hi < other.hi || (hi == other.hi && lo < other.lo);
+    }
+
+    void subtract(const Uint128 &other)
+    {
+        uint64_t borrow = lo < other.lo ? 1 : 0;
+        lo -= other.lo;
+        hi -= other.hi + borrow;
+    }
+
+    int bitLength() const
+    {
+        int bits = 128;
+        uint64_t word = hi;
+        if (word == 0)
+        {
+            bits = 64;
+            word = lo;
+        }
+        while (bits > 0 && !(word >> 63))
+        {
+            word <<= 1;
+            --bits;
+        }
+        return word == 0 && bits == 0 ? 0 : bits;
+    }
+
+    // the 64 low bits of (this >> shift)
+    uint64_t shiftRight(int shift) const
+    {
+        if (shift == 0) return lo;
+        if (shift >= 64) return hi >> (shift - 64);
+        return (lo >> shift) | (hi << (64 - shift));
+    }
+};
+
+// FLOAT_POW5_SPLIT: the 61 leading bits of 5^i
+// FLOAT_POW5_INV_SPLIT: floor(2^(pow5bits(i) - 1 + 59) / 5^i) + 1
+struct Pow5Tables
+{
+    uint64_t split[pow5TableSize];
+    uint64_t invSplit[pow5InvTableSize];
+
+    Pow5Tables()
+    {
+        Uint128 pow5(0, 1);
+        for (int i = 0; i < pow5TableSize; ++i)
+        {
+            int bits = pow5.bitLength();
+            split[i] = bits >= pow5BitCount ? pow5.shiftRight(bits - pow5BitCount) : pow5.lo << (pow5BitCount - bits);
+
+            if (i < pow5InvTableSize)
+            {
+                // long division of 2^shift by 5^i, one bit at a time
+                int shift = pow5bits(i) - 1 + pow5InvBitCount;
+                Uint128 remainder(0, 1);
+                uint64_t quotient = 0;
+                for (int bit = 0; bit < shift; ++bit)
+                {
+                    remainder.shiftLeft1();
+                    quotient <<= 1;
+                    if (!remainder.lessThan(pow5))
+                    {
+                        remainder.subtract(pow5);
+                        quotient |= 1;
+                    }
+                }
+                // the remainder starts at the leading bit of 2^shift, which
+                // is only a quotient bit of its own when dividing by 5^0
+                if (i == 0) quotient = uint64_t(1) << shift;
+                invSplit[i] = quotient + 1;
+            }
+
+            pow5.multiply5();
+        }
+    }
+};
+
+const Pow5Tables &pow5Tables()
+{
+    static const Pow5Tables tables;
+    return tables;
+}
+
+uint32_t pow5Factor(uint32_t value)
+{
+    uint32_t count = 0;
+    for (;;)
+    {
+        uint32_t q = value / 5;
+        uint32_t r = value - 5 * q;
+        if (r != 0) break;
+        value = q;
+        ++count;
+    }
+    return count;
+}
+
+bool multipleOfPowerOf5(uint32_t value, uint32_t p)
+{
+    return pow5Factor(value) >= p;
+}
+
+bool multipleOfPowerOf2(uint32_t value, uint32_t p)
+{
+    return (value & ((1u << p) - 1)) == 0;
+}
+
+uint32_t mulShift32(uint32_t m, uint64_t factor, int32_t shift)
+{
+    uint64_t bits0 = uint64_t(m) * uint32_t(factor);
+    uint64_t bits1 = uint64_t(m) * uint32_t(factor >> 32);
+    uint64_t sum = (bits0 >> 32) + bits1;
+    return uint32_t(sum >> (shift - 32));
+}
+
+uint32_t mulPow5InvDivPow2(uint32_t m, uint32_t q, int32_t j)
+{
+    return mulShift32(m, pow5Tables().invSplit[q], j);
+}
+
+uint32_t mulPow5DivPow2(uint32_t m, uint32_t i, int32_t j)
+{
+    return mulShift32(m, pow5Tables().split[i], j);
+}
+
+// the shortest decimal mantissa * 10^exponent of a finite, non zero float
+void shortestDecimal(uint32_t ieeeMantissa, uint32_t ieeeExponent, uint32_t &mantissa, int32_t &exponent)
+{
+    int32_t e2;
+    uint32_t m2;
+    if (ieeeExponent == 0)
+    {
+        e2 = 1 - exponentBias - mantissaBits - 2;
+        m2 = ieeeMantissa;
+    }
+    else
+    {
+        e2 = int32_t(ieeeExponent) - exponentBias - mantissaBits - 2;
+        m2 = (1u << mantissaBits) | ieeeMantissa;
+    }
+    bool acceptBounds = (m2 & 1) == 0;
+
+    // the interval of the decimals that read back as this float
+    uint32_t mv = 4 * m2;
+    uint32_t mp = 4 * m2 + 2;
+    uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+    uint32_t mm = 4 * m2 - 1 - mmShift;
+
+    uint32_t vr, vp, vm;
+    int32_t e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+    uint32_t lastRemovedDigit = 0;
+
+    if (e2 >= 0)
+    {
+        uint32_t q = log10Pow2(e2);
+        e10 = int32_t(q);
+        int32_t k = pow5InvBitCount + pow5bits(int32_t(q)) - 1;
+        int32_t i = -e2 + int32_t(q) + k;
+        vr = mulPow5InvDivPow2(mv, q, i);
+        vp = mulPow5InvDivPow2(mp, q, i);
+        vm = mulPow5InvDivPow2(mm, q, i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10)
+        {
+            int32_t l = pow5InvBitCount + pow5bits(int32_t(q - 1)) - 1;
+            lastRemovedDigit = mulPow5InvDivPow2(mv, q - 1, -e2 + int32_t(q) - 1 + l) % 10;
+        }
+        if (q <= 9)
+        {
+            // only one of mp, mv and mm can be a multiple of 5
+            if (mv % 5 == 0) vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            else if (acceptBounds) vmIsTrailingZeros = multipleOfPowerOf5(mm, q);
+            else vp -= multipleOfPowerOf5(mp, q);
+        }
+    }
+    else
+    {
+        uint32_t q = log10Pow5(-e2);
+        e10 = int32_t(q) + e2;
+        int32_t i = -e2 - int32_t(q);
+        int32_t k = pow5bits(i) - pow5BitCount;
+        int32_t j = int32_t(q) - k;
+        vr = mulPow5DivPow2(mv, uint32_t(i), j);
+        vp = mulPow5DivPow2(mp, uint32_t(i), j);
+        vm = mulPow5DivPow2(mm, uint32_t(i), j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10)
+        {
+            j = int32_t(q) - 1 - (pow5bits(i + 1) - pow5BitCount);
+            lastRemovedDigit = mulPow5DivPow2(mv, uint32_t(i + 1), j) % 10;
+        }
+        if (q <= 1)
+        {
+            // mv = 4 * m2 has at least two trailing zero bits
+            vrIsTrailingZeros = true;
+            if (acceptBounds) vmIsTrailingZeros = mmShift == 1;
+            else --vp;
+        }
+        else if (q < 31)
+        {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q - 1);
+        }
+    }
+
+    // the shortest decimal in the interval
+    int32_t removed = 0;
+    uint32_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros)
+    {
+        while (vp / 10 > vm / 10)
+        {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vmIsTrailingZeros)
+        {
+            while (vm % 10 == 0)
+            {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        // round to even if the exact number is .....50..0
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) lastRemovedDigit = 4;
+
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+    }
+    else
+    {
+        while (vp / 10 > vm / 10)
+        {
+            lastRemovedDigit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || lastRemovedDigit >= 5);
+    }
+
+    // the interval can end on trailing zeros, they are not needed
+    while (output != 0 && output % 10 == 0)
+    {
+        output /= 10;
+        ++removed;
+    }
+
+    mantissa = output;
+    exponent = e10 + removed;
+}
+
+size_t copyText(const char *text, char *buffer)
+{
+    size_t length = strlen(text);
+    memcpy(buffer, text, length);
+    return length;
+}
+
+}
+
+size_t formatFloat(float value, char *buffer)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    bool sign = (bits >> (mantissaBits + exponentBits)) != 0;
+    uint32_t ieeeMantissa = bits & ((1u << mantissaBits) - 1);
+    uint32_t ieeeExponent = (bits >> mantissaBits) & ((1u << exponentBits) - 1);
+
+    // the special values are written as the streams write them
+    if (ieeeExponent == (1u << exponentBits) - 1)
+    {
+        if (ieeeMantissa != 0) return copyText("nan", buffer);
+        return copyText(sign ? "-inf" : "inf", buffer);
+    }
+
+    size_t length = 0;
+    if (sign) buffer[length++] = '-';
+
+    if (ieeeExponent == 0 && ieeeMantissa == 0)
+    {
+        buffer[length++] = '0';
+        return length;
+    }
+
+    uint32_t mantissa;
+    int32_t exponent;
+    shortestDecimal(ieeeMantissa, ieeeExponent, mantissa, exponent);
+
+    char digits[10];
+    int count = 0;
+    for (uint32_t rest = mantissa; rest != 0; rest /= 10)
+    {
+        digits[count++] = char('0' + rest % 10);
+    }
+
+    // the exponent of the first digit
+    int32_t scientific = exponent + count - 1;
+
+    if (scientific >= -5 && scientific < 12)
+    {
+        if (scientific < 0)
+        {
+            buffer[length++] = '0';
+            buffer[length++] = '.';
+            for (int32_t i = -1; i > scientific; --i) buffer[length++] = '0';
+            for (int i = count - 1; i >= 0; --i) buffer[length++] = digits[i];
+        }
+        else
+        {
+            for (int i = count - 1; i >= 0; --i)
+            {
+                buffer[length++] = digits[i];
+                if (i == count - 1 - scientific && i > 0) buffer[length++] = '.';
+            }
+            for (int32_t i = count - 1; i < scientific; ++i) buffer[length++] = '0';
+        }
+        return length;
+    }
+
+    buffer[length++] = digits[count - 1];
+    if (count > 1)
+    {
+        buffer[length++] = '.';
+        for (int i = count - 2; i >= 0; --i) buffer[length++] = digits[i];
+    }
+
+    buffer[length++] = 'e';
+    buffer[length++] = scientific < 0 ? '-' : '+';
+    uint32_t magnitude = uint32_t(scientific < 0 ? -scientific : scientific);
+    if (magnitude < 10) buffer[length++] = '0';
+    if (magnitude >= 10) buffer[length++] = char('0' + magnitude / 10);
+    buffer[length++] = char('0' + magnitude % 10);
+
+    return length;
+}
+
+} // namespace essentiawrapper
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef FLOAT_FORMAT_H
+#define FLOAT_FORMAT_H
+
+#include <stddef.h>
+
+namespace essentiawrapper {
+
+// enough for "-1.23456789e-38"
+const size_t floatFormatBufferSize = 24;
+
+/**
+ * @brief Writes the shortest decimal text that reads back as exactly the same
+ * float (Ryu), independent of the locale.
+ *
+ * Numbers with a decimal exponent in [-5, 12) are written in fixed notation,
+ * the others in scientific notation, as the streams would with %g. The text
+ * is not null terminated.
+ *
+ * @param buffer At least floatFormatBufferSize characters.
+ * @return The number of characters written.
+ */
+size_t formatFloat(float value, char *buffer);
+
+} // namespace essentiawrapper
+
+#endif // FLOAT_FORMAT_H
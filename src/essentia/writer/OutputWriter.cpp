@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#include "OutputWriter.h"
+
+#include <iostream>
+
+#include "../configuration/config_util.h"
+
+namespace essentiawrapper {
+
+OutputWriter &OutputWriter::instance()
+{
+    static OutputWriter writer;
+    return writer;
+}
+
+OutputWriter::OutputWriter() : _writing(false), _stop(false), _failed(false)
+{
+}
+
+OutputWriter::~OutputWriter()
+{
+    // the queued files are still written
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+    }
+    _queued.notify_all();
+
+    if (_thread.joinable()) _thread.join();
+}
+
+void OutputWriter::write(const shared_ptr<const Pool> &pool, const string &filename, const string &format)
+{
+    unique_lock<mutex> lock(_mutex);
+
+    if (!_thread.joinable()) _thread = thread(&OutputWriter::run, this);
+
+    _written.wait(lock, [this] { return _jobs.size() < capacity; });
+
+    Job job;
+    job.pool = pool;
+    job.filename = filename;
+    job.format = format;
+    _jobs.push_back(job);
+
+    _queued.notify_one();
+}
+
+bool OutputWriter::flush()
+{
+    unique_lock<mutex> lock(_mutex);
+    _written.wait(lock, [this] { return _jobs.empty() && !_writing; });
+
+    bool written = !_failed;
+    _failed = false;
+    return written;
+}
+
+void OutputWriter::run()
+{
+    unique_lock<mutex> lock(_mutex);
+
+    while (true)
+    {
+        _queued.wait(lock, [this] { return !_jobs.empty() || _stop; });
+        if (_jobs.empty()) return;
+
+        Job job = _jobs.front();
+        _jobs.pop_front();
+        _writing = true;
+        _written.notify_all();
+
+        lock.unlock();
+
+        bool written = true;
+        try
+        {
+            writeOutput(*job.pool, job.filename, job.format);
+        }
+        catch (exception &e)
+        {
+            cout << "Writing results to file " << job.filename << " failed: " << e.what() << endl;
+            written = false;
+        }
+        job.pool.reset();
+
+        lock.lock();
+        _writing = false;
+        if (!written) _failed = true;
+        _written.notify_all();
+    }
+}
+
+} // namespace essentiawrapper
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2006-2016  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * Modified by E. Mista, date 12 december 2016
+ *
+ */
+
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "pool.h"
+
+using namespace std;
+using namespace essentia;
+
+namespace essentiawrapper {
+
+/**
+ * @brief Writes the output files on a background thread, so the next file
+ * can be analyzed while the results of the previous one are serialized and
+ * double checked.
+ *
+ * The writer shares the ownership of the pools, which must not change once
+ * they are queued. At most @e capacity pools wait to be written, write()
+ * blocks while the queue is full.
+ */
+class OutputWriter
+{
+public:
+    static const size_t capacity = 2;
+
+    // the writer of the process, its thread is started on the first write
+    static OutputWriter &instance();
+
+    ~OutputWriter();
+
+    void write(const shared_ptr<const Pool> &pool, const string &filename, const string &format);
+
+    /**
+     * @brief Waits until every queued pool is written.
+     * @return false if writing a file failed since the last flush.
+     */
+    bool flush();
+
+private:
+    struct Job
+    {
+        shared_ptr<const Pool> pool;
+        string filename;
+        string format;
+    };
+
+    mutex _mutex;
+    condition_variable _queued;  // a job was queued or the writer stops
+    condition_variable _written; // a job was taken or written
+    deque<Job> _jobs;
+    bool _writing;
+    bool _stop;
+    bool _failed;
+    thread _thread;
+
+    OutputWriter();
+    OutputWriter(const OutputWriter &) = delete;
+    OutputWriter &operator=(const OutputWriter &) = delete;
+
+    void run();
+};
+
+} // namespace essentiawrapper
+
+#endif // OUTPUT_WRITER_H
@@ -21,9 +21,14 @@
  */
 
 #include "YamlOutput.h"
+#include "Checksum.h"
+#include "FloatFormat.h"
 #include "essentia.h"
 #include "utils/output.h" // ../utils/output
+#include <stdint.h>
+#include <algorithm>
 #include <fstream>
+#include <unordered_map>
 #include <sstream> // escapeJsonString
 
 
@@ -159,288 +164,313 @@ string escapeJsonString(const string &input)
     return escaped.str();
 }
 
-// A YamlNode represents a node in the YAML tree. A YamlNode without any value
-// is valid, it is simply a namespace identifier. It is required that every
-// *leaf* node in a YAML tree have a defined value though.
-struct YamlNode
+// A leaf of the output: a descriptor of the pool and its value. The values
+// are not copied, they are emitted from the pool maps.
+struct PoolEntry
 {
-    string name;
-    Parameter *value;
-    vector<YamlNode *> children;
-
-    YamlNode(const string &n) : name(n), value(0) {}
-
-    ~YamlNode()
+    enum Type
     {
-        delete value;
-        for (int i = 0; i < (int)children.size(); ++i)
-        {
-            delete children[i];
-        }
-    }
+        SingleReal,
+        VectorReal,
+        VectorVectorReal,
+        SingleString,
+        VectorString,
+        VectorVectorString,
+        VectorArray2DReal,
+        VectorStereoSample
+    };
+
+    const string *name;
+    Type type;
+    const void *value;
+    vector<string> path;     // the parts of the name between the dots
+    vector<size_t> position; // first appearance of every prefix of the path
 };
 
-
-template <typename IterType>
-void fillYamlTreeHelper(YamlNode *root, const IterType it)
-{
-    vector<string> pathparts = split(it->first);
-    YamlNode *currNode = root;
-
-    // iterate over each of the pieces of the path
-    for (int i = 0; i < (int)pathparts.size(); ++i)
-    {
-        bool newNode = true;
-
-        // search to see if the path part is already in the tree
-        for (int j = 0; j < (int)currNode->children.size(); ++j)
-        {
-            if (currNode->children[j]->name == pathparts[i])   // already in the tree
-            {
-                newNode = false;
-                currNode = currNode->children[j];
-                break;
-            }
-        }
-
-        if (newNode)   // path part was not found in the tree
-        {
-            YamlNode *newNode = new YamlNode(pathparts[i]);
-            currNode->children.push_back(newNode);
-            currNode = newNode;
-        }
-    }
-
-    // end of the path
-    currNode->value = new Parameter(it->second);
-}
-
 /*
- fillYamlTree (Pool, root YamlNode):
- Places all the values from the pool <string, val> into a tree
- e.g. a pool like this:
+ collectPoolEntries (Pool, entries):
+ Lists the values of the pool in the order of the pool maps, e.g. a pool like
+ this:
    foo1.bar  [134.2, 343.234]
    foo2.bar  ["hello"]
 
-
- will get translated to a tree like this:
-
-                     __root
-                    /      \
-                   /        \
-                  /          \
-                 /            \
-                /              \
-              foo1             foo2
-              /                  \
-             /                    \
-   bar ->[ 134.2, 343.234]    bar ->[ "hello"]
-
-
- And the YAML will look like:
+ is output as:
 
  foo1:
      bar: [ 134.2, 343.234]
  foo2:
      bar: [ "hello"]
 
-
+ The namespaces are output in the order they first appear in, so the
+ entries are sorted on the first appearance of every prefix of their name.
 */
+void addPoolEntry(vector<PoolEntry> &entries, const string &name, PoolEntry::Type type, const void *value)
+{
+    PoolEntry entry;
+    entry.name = &name;
+    entry.type = type;
+    entry.value = value;
+    entry.path = split(name);
+    entries.push_back(entry);
+}
 
-void fillYamlTree(const Pool &p, YamlNode *root)
+void collectPoolEntries(const Pool &p, vector<PoolEntry> &entries)
 {
-#define FILL_YAML_TREE_MACRO(type, tname)                                    \
+#define COLLECT_ENTRIES_MACRO(type, tname, entryType)                          \
   for (map<string, type >::const_iterator it = p.get##tname##Pool().begin();   \
        it != p.get##tname##Pool().end(); ++it) {                               \
-    fillYamlTreeHelper(root, it);                                              \
+    addPoolEntry(entries, it->first, PoolEntry::entryType, &it->second);       \
   }
 
-    FILL_YAML_TREE_MACRO(Real, SingleReal);
-    FILL_YAML_TREE_MACRO(vector<Real>, Real);
-    FILL_YAML_TREE_MACRO(vector<Real>, SingleVectorReal);
-    FILL_YAML_TREE_MACRO(vector<vector<Real> >, VectorReal);
+    COLLECT_ENTRIES_MACRO(Real, SingleReal, SingleReal);
+    COLLECT_ENTRIES_MACRO(vector<Real>, Real, VectorReal);
+    COLLECT_ENTRIES_MACRO(vector<Real>, SingleVectorReal, VectorReal);
+    COLLECT_ENTRIES_MACRO(vector<vector<Real> >, VectorReal, VectorVectorReal);
 
-    FILL_YAML_TREE_MACRO(string, SingleString);
-    FILL_YAML_TREE_MACRO(vector<string>, String);
-    FILL_YAML_TREE_MACRO(vector<vector<string> >, VectorString);
+    COLLECT_ENTRIES_MACRO(string, SingleString, SingleString);
+    COLLECT_ENTRIES_MACRO(vector<string>, String, VectorString);
+    COLLECT_ENTRIES_MACRO(vector<vector<string> >, VectorString, VectorVectorString);
 
-    FILL_YAML_TREE_MACRO(vector<TNT::Array2D<Real> >, Array2DReal);
-    FILL_YAML_TREE_MACRO(vector<StereoSample>, StereoSample);
+    COLLECT_ENTRIES_MACRO(vector<TNT::Array2D<Real> >, Array2DReal, VectorArray2DReal);
+    COLLECT_ENTRIES_MACRO(vector<StereoSample>, StereoSample, VectorStereoSample);
 
-#undef FILL_YAML_TREE_MACRO
+#undef COLLECT_ENTRIES_MACRO
 }
 
-
-// Emits YAML given a YamlNode root to a specified stream.
-// This is a recursive solution.
-template <typename StreamType>
-void emitYaml(StreamType *s, YamlNode *n, const string &indent)
+void sortPoolEntries(vector<PoolEntry> &entries)
 {
-    *s << indent << n->name << ":";
+    unordered_map<string, size_t> firstAppearance;
 
-    if (n->children.empty())   // if there are no children, emit the value here
+    for (size_t i = 0; i < entries.size(); ++i)
     {
-        if (n->value != NULL)
-        {
-            *s << " " << *(n->value) << "\n";  // Parameters know how to be emitted to streams
-        }
-        else   // you should never have this case: a key without any children or associated value
+        PoolEntry &entry = entries[i];
+        string prefix;
+
+        entry.position.resize(entry.path.size());
+        for (size_t j = 0; j < entry.path.size(); ++j)
         {
-            throw EssentiaException("YamlOutput: input pool is invalid, contains key with no associated value");
+            if (j > 0) prefix += '.';
+            prefix += entry.path[j];
+            entry.position[j] = firstAppearance.insert(make_pair(prefix, i)).first->second;
         }
     }
-    else
+
+    stable_sort(entries.begin(), entries.end(), [](const PoolEntry &a, const PoolEntry &b)
     {
-        // we can make the assumption that this node has no value because the pool
-        // doesn't not allow parent nodes to have values
-        if (n->value != NULL)
-        {
-            throw EssentiaException(
-                "YamlOutput: input pool is invalid, a parent key should not have a"
-                "value in addition to child keys");
-        }
+        return a.position < b.position;
+    });
+}
 
-        *s << "\n";
+// the number of leading path parts shared by two entries
+size_t commonPath(const PoolEntry &a, const PoolEntry &b)
+{
+    size_t common = 0;
+    while (common < a.path.size() && common < b.path.size() && a.position[common] == b.position[common])
+    {
+        ++common;
+    }
 
-        // and then emit the yaml for all of its children, recursive call
-        for (int i = 0; i < (int)n->children.size(); ++i)
-        {
-            emitYaml(s, n->children[i], indent + "    ");
-        }
+    if (common == a.path.size() || common == b.path.size())
+    {
+        throw EssentiaException(
+            "YamlOutput: input pool is invalid, a parent key should not have a"
+            "value in addition to child keys");
     }
+
+    return common;
 }
 
+// The shortest text that reads back as the same float, whatever the locale
+// and the precision of the stream.
+template <typename StreamType>
+void emitReal(StreamType *s, Real value)
+{
+    char buffer[essentiawrapper::floatFormatBufferSize];
+    s->write(buffer, essentiawrapper::formatFloat(value, buffer));
+}
 
+// "[a, b]", as the streams write the vectors
 template <typename StreamType>
-void emitJson(StreamType *s, YamlNode *n, int indentsize, int indentincr)
+void emitReals(StreamType *s, const vector<Real> &values)
 {
-    const string indent = string(indentsize, ' ');
-    *s << indent << "\"" << escapeJsonString(n->name) << "\": ";
+    s->put('[');
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (i > 0) s->write(", ", 2);
+        emitReal(s, values[i]);
+    }
+    s->put(']');
+}
 
-    if (n->children.empty())   // if there are no children, emit the value here
+template <typename StreamType>
+void emitValue(StreamType *s, const PoolEntry &entry, bool json)
+{
+    // the real values are the bulk of the output, they are emitted without
+    // going through a Parameter
+    switch (entry.type)
+    {
+    case PoolEntry::SingleReal:
+        emitReal(s, *static_cast<const Real *>(entry.value));
+        return;
+    case PoolEntry::VectorReal:
+        emitReals(s, *static_cast<const vector<Real> *>(entry.value));
+        return;
+    case PoolEntry::VectorVectorReal:
     {
-        if (n->value != NULL)
+        const vector<vector<Real> > &rows = *static_cast<const vector<vector<Real> > *>(entry.value);
+        s->put('[');
+        for (size_t i = 0; i < rows.size(); ++i)
         {
-
-            // Escape string or vector of strings values for json compatibility
-            // FIXME Instead, is it possible to add an option to escape strings inside '<<'
-            // implementation for Parameters themselves?
-            Parameter::ParamType nodeType = (*(n->value)).type();
-            if (nodeType == Parameter::STRING)
-            {
-                *s << "\"" << escapeJsonString((*(n->value)).toString()) << "\"";
-            }
-            else if (nodeType == Parameter::VECTOR_STRING)
-            {
-                vector<string> escaped = (*(n->value)).toVectorString();
-                for (size_t i = 0; i < escaped.size(); ++i)
-                {
-                    escaped[i] = "\"" + escapeJsonString(escaped[i]) + "\"";
-                }
-                *s << escaped;
-            }
-            else
-            {
-                *s << *(n->value); // Parameters know how to be emitted to streams
-            }
+            if (i > 0) s->write(", ", 2);
+            emitReals(s, rows[i]);
         }
-        else   // you should never have this case: a key without any children or associated value
+        s->put(']');
+        return;
+    }
+    default:
+        break;
+    }
+
+    Parameter value(Parameter::UNDEFINED);
+    switch (entry.type)
+    {
+    case PoolEntry::SingleString:
+        value = Parameter(*static_cast<const string *>(entry.value));
+        break;
+    case PoolEntry::VectorString:
+        value = Parameter(*static_cast<const vector<string> *>(entry.value));
+        break;
+    case PoolEntry::VectorVectorString:
+        value = Parameter(*static_cast<const vector<vector<string> > *>(entry.value));
+        break;
+    case PoolEntry::VectorArray2DReal:
+        value = Parameter(*static_cast<const vector<TNT::Array2D<Real> > *>(entry.value));
+        break;
+    case PoolEntry::VectorStereoSample:
+        value = Parameter(*static_cast<const vector<StereoSample> *>(entry.value));
+        break;
+    default:
+        break;
+    }
+
+    // Escape string or vector of strings values for json compatibility
+    // FIXME Instead, is it possible to add an option to escape strings inside '<<'
+    // implementation for Parameters themselves?
+    if (json && value.type() == Parameter::STRING)
+    {
+        *s << "\"" << escapeJsonString(value.toString()) << "\"";
+    }
+    else if (json && value.type() == Parameter::VECTOR_STRING)
+    {
+        vector<string> escaped = value.toVectorString();
+        for (size_t i = 0; i < escaped.size(); ++i)
         {
-            throw EssentiaException("JsonOutput: input pool is invalid, contains key with no associated value");
+            escaped[i] = "\"" + escapeJsonString(escaped[i]) + "\"";
         }
+        *s << escaped;
     }
     else
     {
-        // we can make the assumption that this node has no value because the pool
-        // doesn't not allow parent nodes to have values
-        if (n->value != NULL)
-        {
-            throw EssentiaException(
-                "JsonOutput: input pool is invalid, a parent key should not have a"
-                "value in addition to child keys");
-        }
+        *s << value; // Parameters know how to be emitted to streams
+    }
+}
 
-        *s << "{" << _jsonN;
+// Emits the YAML of the sorted entries in one pass, every namespace is
+// written when its first descriptor is reached.
+void outputYamlToStream(const vector<PoolEntry> &entries, ostream *out)
+{
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const PoolEntry &entry = entries[i];
+        size_t common = i > 0 ? commonPath(entries[i - 1], entry) : 0;
 
-        // and then emit the json for all of its children, recursive call
-        int childrensize = (int)n->children.size();
-        for (int i = 0; i < childrensize; ++i)
+        if (common == 0) *out << "\n";
+
+        for (size_t level = common; level + 1 < entry.path.size(); ++level)
         {
-            emitJson(s, n->children[i], indentsize + indentincr, indentincr);
-            if (i < childrensize - 1)
-            {
-                *s << ",";
-            }
-            *s << _jsonN;
+            *out << string(4 * level, ' ') << entry.path[level] << ":\n";
         }
 
-        *s << indent << "}";
+        *out << string(4 * (entry.path.size() - 1), ' ') << entry.path.back() << ": ";
+        emitValue(out, entry, false);
+        *out << "\n";
     }
 }
 
-
-void outputYamlToStream(YamlNode &root, ostream *out)
+// Emits the JSON of the sorted entries in one pass, the objects are closed
+// when the next descriptor leaves their namespace.
+void outputJsonToStream(const vector<PoolEntry> &entries, ostream *out, int indentincr)
 {
-    for (int i = 0; i < (int)root.children.size(); ++i)
+    *out << "{" << _jsonN;
+
+    for (size_t i = 0; i < entries.size(); ++i)
     {
-        *out << "\n";
-        emitYaml(out, root.children[i], "");
-    }
-}
+        const PoolEntry &entry = entries[i];
+        size_t common = 0;
 
+        if (i > 0)
+        {
+            const PoolEntry &previous = entries[i - 1];
+            common = commonPath(previous, entry);
 
-void outputJsonToStream(YamlNode &root, ostream *out, int indentincr)
-{
-    *out << "{" << _jsonN;
-    for (int i = 0; i < (int)root.children.size(); ++i)
+            for (size_t level = previous.path.size() - 1; level > common; --level)
+            {
+                *out << _jsonN << string(indentincr * (level - 1), ' ') << "}";
+            }
+            *out << "," << _jsonN;
+        }
+
+        for (size_t level = common; level + 1 < entry.path.size(); ++level)
+        {
+            *out << string(indentincr * level, ' ') << "\"" << escapeJsonString(entry.path[level]) << "\": {" << _jsonN;
+        }
+
+        *out << string(indentincr * (entry.path.size() - 1), ' ') << "\"" << escapeJsonString(entry.path.back()) << "\": ";
+        emitValue(out, entry, true);
+    }
+
+    if (!entries.empty())
     {
-        emitJson(out, root.children[i], 0, indentincr);
-        if (i < (int)root.children.size() - 1)
+        const PoolEntry &last = entries.back();
+        for (size_t level = last.path.size() - 1; level > 0; --level)
         {
-            *out << ",";
+            *out << _jsonN << string(indentincr * (level - 1), ' ') << "}";
         }
         *out << _jsonN;
     }
+
     *out << "}";
 }
 
 
 void YamlOutput::outputToStream(ostream *out)
 {
-    // set precision to be high enough
+    // the reals are written with the shortest round trip text, the precision
+    // is left for the matrices and stereo samples written by the Parameters
     out->precision(12);
 
     const Pool &p = _pool.get();
 
-    // create the YamlNode Tree
-    YamlNode root("doesn't matter what I put here, it's not getting emitted");
+    vector<PoolEntry> entries;
 
-    // add metadata.version.essentia to the tree
+    // add metadata.version.essentia before the values of the pool
+    const string versionName = "metadata.version.essentia";
+    const string version = essentia::version;
     if (_writeVersion)
     {
-        YamlNode *essentiaNode = new YamlNode("essentia");
-
-        essentiaNode->value = new Parameter(essentia::version);
-
-        YamlNode *versionNode = new YamlNode("version");
-        versionNode->children.push_back(essentiaNode);
-
-        YamlNode *metadataNode = new YamlNode("metadata");
-        metadataNode->children.push_back(versionNode);
-
-        root.children.push_back(metadataNode);
+        addPoolEntry(entries, versionName, PoolEntry::SingleString, &version);
     }
 
-    // fill the YAML tree with the values form the pool
-    fillYamlTree(p, &root);
+    collectPoolEntries(p, entries);
+    sortPoolEntries(entries);
 
     if (_outputJSON)
     {
-        outputJsonToStream(root, out, _indent);
+        outputJsonToStream(entries, out, _indent);
     }
     else
     {
-        outputYamlToStream(root, out);
+        outputYamlToStream(entries, out);
     }
 }
 
@@ -451,31 +481,32 @@ void YamlOutput::compute()
     {
         outputToStream(&cout);
     }
-    else
+    else if (!_doubleCheck)
     {
         ofstream out(_filename.c_str());
         outputToStream(&out);
         out.close();
+    }
+    else
+    {
+        ofstream file(_filename.c_str());
+        ChecksumBuffer checksum(file.rdbuf());
+        ostream out(&checksum);
+        outputToStream(&out);
+        out.flush();
+        file.close();
 
-        if (_doubleCheck)
+        // read the file we just wrote, in text mode as it was written
+        uint64_t hash;
+        uint64_t size;
+        if (!fileChecksum(_filename, ios_base::in, hash, size))
         {
-            ostringstream expected;
-            outputToStream(&expected);
+            throw EssentiaException("YamlOutput: error when double-checking the output file; it doesn't look like it was written at all");
+        }
 
-            // read the file we just wrote...
-            ifstream f(_filename.c_str());
-            if (!f.good())
-            {
-                throw EssentiaException("YamlOutput: error when double-checking the output file; it doesn't look like it was written at all");
-            }
-            ostringstream written;
-            // we need to compare using streambuffers or otherwise
-            // the check fails on windows due to new lines
-            written << f.rdbuf();
-            if (written.str() != expected.str())
-            {
-                throw EssentiaException("YamlOutput: error when double-checking the output file; it doesn't match the expected output");
-            }
+        if (!out.good() || size != checksum.size() || hash != checksum.hash())
+        {
+            throw EssentiaException("YamlOutput: error when double-checking the output file; it doesn't match the expected output");
         }
     }
 }
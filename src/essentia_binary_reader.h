@@ -0,0 +1,288 @@
+#ifndef ESSENTIA_BINARY_READER_H_
+#define ESSENTIA_BINARY_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+    The binary result file, written with pool.set("outputFormat", "binary").
+
+    All the numbers are little endian, the offsets are from the start of the file.
+
+    header, 64 bytes
+        char     magic[8]           "ESSBIN\0\0"
+        uint32_t version            ESSENTIA_BINARY_VERSION
+        uint32_t entry_count
+        uint64_t index_offset       the entries, sorted on the bytes of their names
+        uint64_t names_offset       the null terminated descriptor names
+        uint64_t file_size
+        uint8_t  reserved[24]
+
+    entry, 64 bytes
+        uint64_t name_offset
+        uint32_t name_length        without the terminating null
+        uint32_t type               essentia_binary_type
+        uint32_t rank               0 for single values, up to 3
+        uint32_t flags              essentia_binary_flags
+        uint64_t shape[3]           the unused dimensions are 0
+        uint64_t data_offset        64 byte aligned
+        uint64_t data_size
+
+    data of an entry
+        ragged entries, rank 2 with shape [rows, 0]:
+            uint64_t row_offsets[rows + 1]    the first element of every row, padded to 64 bytes
+        reals:
+            float    values[]                 row major, 64 byte aligned
+        strings:
+            uint64_t string_offsets[count + 1] from the first string, padded to 64 bytes
+            char     strings[]                null terminated
+
+    The reader works on the file mapped in memory (mmap, MapViewOfFile) or read in a
+    buffer aligned on 64 bytes, no value is copied or converted. It only supports little
+    endian hosts.
+*/
+
+#define ESSENTIA_BINARY_VERSION 1
+#define ESSENTIA_BINARY_ALIGNMENT 64
+#define ESSENTIA_BINARY_HEADER_SIZE 64
+#define ESSENTIA_BINARY_ENTRY_SIZE 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const char essentia_binary_magic[8] = { 'E', 'S', 'S', 'B', 'I', 'N', 0, 0 };
+
+/**
+ * @brief The essentia_binary_type enum is the type of the values of an entry.
+ */
+enum essentia_binary_type
+{
+    ESSENTIA_BINARY_REAL = 1,  //!< 32 bit floats
+    ESSENTIA_BINARY_STRING = 2 //!< null terminated UTF-8 strings
+};
+
+/**
+ * @brief The essentia_binary_flags enum
+ */
+enum essentia_binary_flags
+{
+    ESSENTIA_BINARY_RAGGED = 1 //!< the rows have different lengths, see essentia_binary_row
+};
+
+/**
+ * @brief The essentia_binary_file struct is a binary result file in memory.
+ */
+typedef struct essentia_binary_file
+{
+    const uint8_t* data;
+    uint64_t size;
+    uint32_t entry_count;
+} essentia_binary_file;
+
+/**
+ * @brief The essentia_binary_entry struct is one descriptor of the file, pointing into it.
+ */
+typedef struct essentia_binary_entry
+{
+    const char* name;
+    uint32_t type;                  //!< essentia_binary_type
+    uint32_t rank;
+    uint32_t flags;                 //!< essentia_binary_flags
+    uint64_t shape[3];
+    uint64_t count;                 //!< the number of values of all rows
+    const uint64_t* row_offsets;    //!< rows + 1 offsets for ragged entries, otherwise NULL
+    const float* reals;             //!< the values of real entries, otherwise NULL
+    const uint64_t* string_offsets; //!< count + 1 offsets for string entries, otherwise NULL
+    const char* strings;            //!< the first string of string entries, otherwise NULL
+} essentia_binary_entry;
+
+static inline uint32_t essentia_binary_u32(const uint8_t* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t essentia_binary_u64(const uint8_t* p)
+{
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t essentia_binary_align(uint64_t offset)
+{
+    return (offset + ESSENTIA_BINARY_ALIGNMENT - 1) & ~(uint64_t)(ESSENTIA_BINARY_ALIGNMENT - 1);
+}
+
+/**
+ * @brief essentia_binary_open Checks the header of a file in memory.
+ * @param file The file to initialize.
+ * @param data The start of the file, at least 8 byte aligned.
+ * @param size The size of the file.
+ * @return 0 on success, -1 if the memory does not hold a complete binary result file.
+ */
+static inline int essentia_binary_open(essentia_binary_file* file, const void* data, uint64_t size)
+{
+    const uint16_t endianness = 1;
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t index_offset;
+
+    if (*(const uint8_t*)&endianness != 1) return -1;
+    if (size < ESSENTIA_BINARY_HEADER_SIZE || memcmp(bytes, essentia_binary_magic, 8) != 0) return -1;
+    if (essentia_binary_u32(bytes + 8) != ESSENTIA_BINARY_VERSION) return -1;
+    if (essentia_binary_u64(bytes + 32) != size) return -1;
+
+    file->data = bytes;
+    file->size = size;
+    file->entry_count = essentia_binary_u32(bytes + 12);
+
+    index_offset = essentia_binary_u64(bytes + 16);
+    if (index_offset > size || (size - index_offset) / ESSENTIA_BINARY_ENTRY_SIZE < file->entry_count) return -1;
+
+    return 0;
+}
+
+/**
+ * @brief essentia_binary_entry_at Resolves one entry of the index.
+ * @param file The opened file.
+ * @param index The entry, from 0 to entry_count - 1.
+ * @param entry The entry to fill.
+ * @return 0 on success, -1 if the index is out of range or the entry is damaged.
+ */
+static inline int essentia_binary_entry_at(const essentia_binary_file* file, uint32_t index, essentia_binary_entry* entry)
+{
+    const uint8_t* e;
+    uint64_t name_offset, name_length, data_offset, data_size, values_offset, i;
+
+    if (index >= file->entry_count) return -1;
+    e = file->data + essentia_binary_u64(file->data + 16) + (uint64_t)index * ESSENTIA_BINARY_ENTRY_SIZE;
+
+    name_offset = essentia_binary_u64(e);
+    name_length = essentia_binary_u32(e + 8);
+    if (name_offset > file->size || file->size - name_offset <= name_length) return -1;
+    if (file->data[name_offset + name_length] != 0) return -1;
+
+    entry->name = (const char*)(file->data + name_offset);
+    entry->type = essentia_binary_u32(e + 12);
+    entry->rank = essentia_binary_u32(e + 16);
+    entry->flags = essentia_binary_u32(e + 20);
+    for (i = 0; i < 3; ++i) entry->shape[i] = essentia_binary_u64(e + 24 + 8 * i);
+    data_offset = essentia_binary_u64(e + 48);
+    data_size = essentia_binary_u64(e + 56);
+
+    if (entry->rank > 3 || data_offset % ESSENTIA_BINARY_ALIGNMENT != 0) return -1;
+    if (data_offset > file->size || file->size - data_offset < data_size) return -1;
+
+    entry->row_offsets = NULL;
+    entry->reals = NULL;
+    entry->string_offsets = NULL;
+    entry->strings = NULL;
+    values_offset = data_offset;
+
+    if (entry->flags & ESSENTIA_BINARY_RAGGED)
+    {
+        uint64_t table = (entry->shape[0] + 1) * sizeof(uint64_t);
+        if (entry->rank != 2 || data_size < table) return -1;
+        entry->row_offsets = (const uint64_t*)(file->data + data_offset);
+        entry->count = entry->row_offsets[entry->shape[0]];
+        values_offset = essentia_binary_align(data_offset + table);
+    }
+    else
+    {
+        entry->count = 1;
+        for (i = 0; i < entry->rank; ++i) entry->count *= entry->shape[i];
+    }
+
+    if (entry->type == ESSENTIA_BINARY_REAL)
+    {
+        if (values_offset + entry->count * sizeof(float) > data_offset + data_size) return -1;
+        entry->reals = (const float*)(file->data + values_offset);
+    }
+    else if (entry->type == ESSENTIA_BINARY_STRING)
+    {
+        uint64_t table = (entry->count + 1) * sizeof(uint64_t);
+        if (values_offset + table > data_offset + data_size) return -1;
+        entry->string_offsets = (const uint64_t*)(file->data + values_offset);
+        entry->strings = (const char*)(file->data + essentia_binary_align(values_offset + table));
+        if ((const uint8_t*)entry->strings + entry->string_offsets[entry->count] > file->data + data_offset + data_size) return -1;
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief essentia_binary_find Looks a descriptor up by name, with a binary search of the index.
+ * @param file The opened file.
+ * @param name The full descriptor name, e.g. "lowlevel.mfcc.mean".
+ * @param entry The entry to fill.
+ * @return 0 on success, -1 if the descriptor is not in the file.
+ */
+static inline int essentia_binary_find(const essentia_binary_file* file, const char* name, essentia_binary_entry* entry)
+{
+    uint32_t low = 0;
+    uint32_t high = file->entry_count;
+
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+        int order;
+
+        if (essentia_binary_entry_at(file, middle, entry) != 0) return -1;
+
+        order = strcmp(entry->name, name);
+        if (order == 0) return 0;
+        if (order < 0) low = middle + 1;
+        else high = middle;
+    }
+    return -1;
+}
+
+/**
+ * @brief essentia_binary_row The first value and the length of one row of an entry.
+ *
+ * The rows are the first dimension, a rank 0 entry has one row of one value.
+ *
+ * @param entry The entry.
+ * @param row The row, from 0 to shape[0] - 1.
+ * @param length The number of values of the row.
+ * @return The index of the first value of the row in reals or string_offsets.
+ */
+static inline uint64_t essentia_binary_row(const essentia_binary_entry* entry, uint64_t row, uint64_t* length)
+{
+    uint64_t size = 1;
+    uint32_t i;
+
+    if (entry->row_offsets)
+    {
+        *length = entry->row_offsets[row + 1] - entry->row_offsets[row];
+        return entry->row_offsets[row];
+    }
+
+    for (i = 1; i < entry->rank; ++i) size *= entry->shape[i];
+    *length = size;
+    return row * size;
+}
+
+/**
+ * @brief essentia_binary_string One string of a string entry.
+ * @param entry The entry.
+ * @param index The string, from 0 to count - 1.
+ * @return The null terminated string.
+ */
+static inline const char* essentia_binary_string(const essentia_binary_entry* entry, uint64_t index)
+{
+    return entry->strings + entry->string_offsets[index];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ESSENTIA_BINARY_READER_H_
@@ -2,7 +2,14 @@
 #include <algorithm>
 #include <cstring>
 #include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include "essentia/AllDetectionAlgorithms.h"
+#include "essentia/HostAllocator.h"
+#include "essentia/standard/StreamFrameSink.h"
+#include "essentia/writer/OutputWriter.h"
 #include "pool.h"
 
 namespace {
@@ -54,32 +61,68 @@ void free_essentia_timestamps(essentia_timestamps *ts)
         return;
     }
 
-    if(ts->ts) {
-        delete[] ts->ts;
-    }
+    // the array and all the series are one block
+    essentiawrapper::releaseHostBlock(ts);
+}
 
-    delete[] ts;
+// the result descriptor of every essentia_ts_type
+const char *timestampDescriptor(essentia_ts_type type)
+{
+    switch (type)
+    {
+    case Beats:           return "rhythm.beats.position";
+    case BPM:             return "rhythm.bpm";
+    case Segments:        return "segmentation.timestamps";
+    case FadeIns:         return "fades.fadeIns";
+    case FadeOuts:        return "fades.fadeOuts";
+    case Onsets:          return "rhythm.onset_times";
+    case AverageLoudness: return "average_loudness";
+    case Danceability:    return "rhythm.danceability";
+    }
+    return nullptr;
 }
 
-void convertAndAdd(std::vector<essentia_timestamps> &et_vec, const std::vector<float> &resVec, essentia_ts_type type)
+essentia_timestamps *collectTimestamps(essentiawrapper::AllDetectionAlgorithms &algo, bool neqloud, uint32_t *count)
 {
-    if (resVec.empty())
+    const essentia_ts_type types[] = { Beats, BPM, Segments, FadeIns, FadeOuts, Onsets, AverageLoudness, Danceability };
+
+    // sized first, so the values are copied once, from the pool to a single
+    // block from the host allocator holding the array and every series
+    std::vector<essentia_timestamps> et_vec;
+    et_vec.reserve(std::end(types) - std::begin(types));
+
+    size_t values = 0;
+    for (essentia_ts_type type : types)
     {
-        return;
+        const size_t size = algo.copy(timestampDescriptor(type), !neqloud, nullptr, 0);
+        if (size == 0)
+        {
+            continue;
+        }
+
+        et_vec.push_back(essentia_timestamps{nullptr, static_cast<uint32_t>(size), type});
+        values += size;
     }
 
-    const size_t size = resVec.size();
+    const size_t size = et_vec.size();
+
+    *count = static_cast<uint32_t>(size);
+
+    void *block = essentiawrapper::allocateHostBlock(size * sizeof(essentia_timestamps) + values * sizeof(float));
+    essentia_timestamps *timestamps = static_cast<essentia_timestamps *>(block);
+    float *ts = reinterpret_cast<float *>(timestamps + size);
 
-    essentia_timestamps et;
-    et.tsCount = size;
-    et.type = type;
-    et.ts = new float[size];
     for (size_t i = 0; i < size; ++i)
     {
-        et.ts[i] = resVec[i];
+        essentia_timestamps &et = et_vec[i];
+        et.ts = ts;
+        algo.copy(timestampDescriptor(et.type), !neqloud, et.ts, et.tsCount);
+        ts += et.tsCount;
+
+        timestamps[i] = et;
     }
 
-    et_vec.push_back(et);
+    return timestamps;
 }
 
 essentia_timestamps *essentia_analyze(callbacks *cb, uint32_t *count)
@@ -97,25 +140,293 @@ essentia_timestamps *essentia_analyze(callbacks *cb, uint32_t *count)
 
     algo.analyze(cb, localConfigPool);
 
-    std::vector<essentia_timestamps> et_vec;
+    return collectTimestamps(algo, neqloud, count);
+}
 
-    convertAndAdd(et_vec, algo.get("rhythm.beats.position", !neqloud), Beats);
-    convertAndAdd(et_vec, algo.get("rhythm.bpm", !neqloud), BPM);
-    convertAndAdd(et_vec, algo.get("segmentation.timestamps", !neqloud), Segments);
-    convertAndAdd(et_vec, algo.get("fades.fadeIns", !neqloud), FadeIns);
-    convertAndAdd(et_vec, algo.get("fades.fadeOuts", !neqloud), FadeOuts);
-    convertAndAdd(et_vec, algo.get("rhythm.onset_times", !neqloud), Onsets);
-    convertAndAdd(et_vec, algo.get("average_loudness", !neqloud), AverageLoudness);
-    convertAndAdd(et_vec, algo.get("rhythm.danceability", !neqloud), Danceability);
+struct essentia_plan
+{
+    essentiawrapper::AllDetectionAlgorithms algo;
+    bool neqloud;
+};
 
-    const size_t size = et_vec.size();
+essentia_plan *essentia_plan_create()
+{
+    std::unique_ptr<essentia_plan> plan(new essentia_plan());
 
-    *count = static_cast<uint32_t>(size);
+    const essentia::Pool &config = configPool();
 
-    essentia_timestamps *timestamps = new essentia_timestamps[size];
-    std::copy(std::begin(et_vec), std::end(et_vec), timestamps);
+    plan->neqloud = config.contains<essentia::Real>("nequalLoudness") && config.value<essentia::Real>("nequalLoudness");
 
-    return timestamps;
+    try
+    {
+        plan->algo.compile(config);
+    }
+    catch (essentia::EssentiaException &)
+    {
+        return nullptr;
+    }
+
+    return plan.release();
+}
+
+essentia_timestamps *essentia_plan_analyze(essentia_plan *plan, callbacks *cb, uint32_t *count)
+{
+    if (plan == nullptr || count == nullptr)
+    {
+        return nullptr;
+    }
+
+    plan->algo.analyze(cb);
+
+    return collectTimestamps(plan->algo, plan->neqloud, count);
+}
+
+uint32_t essentia_plan_get_timestamps(essentia_plan *plan, essentia_ts_type type, float *buffer, uint32_t capacity)
+{
+    const char *name = timestampDescriptor(type);
+    if (plan == nullptr || name == nullptr)
+    {
+        return 0;
+    }
+
+    return static_cast<uint32_t>(plan->algo.copy(name, !plan->neqloud, buffer, capacity));
+}
+
+void essentia_plan_destroy(essentia_plan *plan)
+{
+    delete plan;
+}
+
+bool essentia_flush_output()
+{
+    return essentiawrapper::OutputWriter::instance().flush();
+}
+
+bool essentia_set_allocator(malloc_fct malloc_fn, free_fct free_fn, void *ctx)
+{
+    if (!malloc_fn != !free_fn)
+    {
+        return false;
+    }
+
+    essentiawrapper::setHostAllocator(essentiawrapper::HostAllocatorHooks{malloc_fn, free_fn, ctx});
+    return true;
+}
+
+uint32_t essentia_set_frame_sink(const char* name, frame_sink_fct sink)
+{
+    if (!name)
+    {
+        return UINT32_MAX;
+    }
+
+    return essentiawrapper::FrameSinkRegistry::instance().set(name, sink);
+}
+
+struct essentia_results
+{
+    std::shared_ptr<const essentia::Pool> pool;
+
+    // the matrices made contiguous and the sorted names, on first use
+    std::mutex mutex;
+    std::map<std::string, essentiawrapper::HostVector<essentia::Real> > matrices;
+    std::vector<std::string> names;
+};
+
+namespace {
+
+static_assert(sizeof(essentia::Real) == sizeof(float), "the results are returned as floats");
+
+essentia_results *createResults(essentiawrapper::AllDetectionAlgorithms &algo, bool neqloud)
+{
+    std::shared_ptr<const essentia::Pool> pool = algo.results(!neqloud);
+    if (!pool)
+    {
+        return nullptr;
+    }
+
+    essentia_results *results = new essentia_results();
+    results->pool = pool;
+    return results;
+}
+
+template<class T>
+const T *findValue(const std::map<std::string, T> &values, const char *name)
+{
+    auto it = values.find(name);
+    return it == values.end() ? nullptr : &it->second;
+}
+
+}
+
+essentia_results *essentia_analyze_results(callbacks *cb)
+{
+    essentiawrapper::AllDetectionAlgorithms algo;
+
+    essentia::Pool localConfigPool = configPool();
+
+    bool neqloud = localConfigPool.contains<essentia::Real>("nequalLoudness") && localConfigPool.value<essentia::Real>("nequalLoudness");
+
+    try
+    {
+        algo.analyze(cb, localConfigPool);
+    }
+    catch (essentia::EssentiaException &)
+    {
+        return nullptr;
+    }
+
+    return createResults(algo, neqloud);
+}
+
+essentia_results *essentia_plan_results(essentia_plan *plan)
+{
+    if (plan == nullptr)
+    {
+        return nullptr;
+    }
+
+    return createResults(plan->algo, plan->neqloud);
+}
+
+bool essentia_results_get(essentia_results *results, const char *name, const float **data, essentia_shape *shape)
+{
+    if (!results || !name || !data || !shape)
+    {
+        return false;
+    }
+
+    const essentia::Pool &pool = *results->pool;
+
+    if (const essentia::Real *value = findValue(pool.getSingleRealPool(), name))
+    {
+        *data = value;
+        *shape = essentia_shape{0, {0, 0}};
+        return true;
+    }
+
+    const std::vector<essentia::Real> *vector = findValue(pool.getSingleVectorRealPool(), name);
+    if (!vector) vector = findValue(pool.getRealPool(), name);
+    if (vector)
+    {
+        *data = vector->data();
+        *shape = essentia_shape{1, {static_cast<uint32_t>(vector->size()), 0}};
+        return true;
+    }
+
+    const std::vector<std::vector<essentia::Real> > *rows = findValue(pool.getVectorRealPool(), name);
+    if (!rows)
+    {
+        return false;
+    }
+
+    const size_t columns = rows->empty() ? 0 : rows->front().size();
+    for (const std::vector<essentia::Real> &row : *rows)
+    {
+        if (row.size() != columns)
+        {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(results->mutex);
+
+    auto inserted = results->matrices.insert(std::make_pair(std::string(name), essentiawrapper::HostVector<essentia::Real>()));
+    essentiawrapper::HostVector<essentia::Real> &matrix = inserted.first->second;
+    if (inserted.second)
+    {
+        matrix.reserve(rows->size() * columns);
+        for (const std::vector<essentia::Real> &row : *rows)
+        {
+            matrix.insert(matrix.end(), row.begin(), row.end());
+        }
+    }
+
+    *data = matrix.data();
+    *shape = essentia_shape{2, {static_cast<uint32_t>(rows->size()), static_cast<uint32_t>(columns)}};
+    return true;
+}
+
+bool essentia_results_get_string(essentia_results *results, const char *name, uint32_t index, const char **value, uint32_t *count)
+{
+    if (!results || !name || !value)
+    {
+        return false;
+    }
+
+    const essentia::Pool &pool = *results->pool;
+
+    if (const std::string *single = findValue(pool.getSingleStringPool(), name))
+    {
+        if (count) *count = 1;
+        if (index != 0) return false;
+
+        *value = single->c_str();
+        return true;
+    }
+
+    if (const std::vector<std::string> *strings = findValue(pool.getStringPool(), name))
+    {
+        if (count) *count = static_cast<uint32_t>(strings->size());
+        if (index >= strings->size()) return false;
+
+        *value = (*strings)[index].c_str();
+        return true;
+    }
+
+    return false;
+}
+
+namespace {
+
+const std::vector<std::string> &resultNames(essentia_results *results)
+{
+    std::lock_guard<std::mutex> lock(results->mutex);
+
+    if (results->names.empty())
+    {
+        const essentia::Pool &pool = *results->pool;
+        std::vector<std::string> &names = results->names;
+
+        for (const auto &value : pool.getSingleRealPool()) names.push_back(value.first);
+        for (const auto &value : pool.getSingleVectorRealPool()) names.push_back(value.first);
+        for (const auto &value : pool.getRealPool()) names.push_back(value.first);
+        for (const auto &value : pool.getVectorRealPool()) names.push_back(value.first);
+        for (const auto &value : pool.getSingleStringPool()) names.push_back(value.first);
+        for (const auto &value : pool.getStringPool()) names.push_back(value.first);
+
+        std::sort(names.begin(), names.end());
+    }
+
+    return results->names;
+}
+
+}
+
+uint32_t essentia_results_count(essentia_results *results)
+{
+    if (!results)
+    {
+        return 0;
+    }
+
+    return static_cast<uint32_t>(resultNames(results).size());
+}
+
+const char *essentia_results_name(essentia_results *results, uint32_t index)
+{
+    if (!results)
+    {
+        return nullptr;
+    }
+
+    const std::vector<std::string> &names = resultNames(results);
+    return index < names.size() ? names[index].c_str() : nullptr;
+}
+
+void essentia_results_destroy(essentia_results *results)
+{
+    delete results;
 }
 
 bool essentia_set_config_value_f(const char *name, float value)
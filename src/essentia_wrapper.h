@@ -1,6 +1,7 @@
 #ifndef ESSENTIA_WRAPPER_H_
 #define ESSENTIA_WRAPPER_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include "essentia-wrapper_exports.h"
 
@@ -19,7 +20,8 @@
 
     pool.set("equalOutputPath", "");                        // string                           | equal result output to file
     pool.set("nequalOutputPath", "");                       // string                           | nequal result output to file
-    pool.set("outputFormat", "json");                       // {yaml,json}                      | result output format
+    pool.set("outputFormat", "json");                       // {yaml,json,binary}               | result output format, binary see essentia_binary_reader.h
+    pool.set("outputAsync", false);                         // {false,true}                     | write the output files on a background thread, see essentia_flush_output
 
     pool.set("skipReplayGain", false);                      // {false,true}                     | if true use standard values, saves some time, possibly different results
 
@@ -83,6 +85,27 @@
                                                             //  blackmanharris62/70/74/92}
     pool.set("lowlevel.silentFrames", "noise");             // {drop,keep,noise}                | whether to [keep/drop/add noise to] silent frames
 
+    // lowlevel descriptors, only computed if lowlevel.compute is set
+    pool.set("lowlevel.silence_rate.compute", true);        // {false,true}                     | silence_rate_20dB/30dB/60dB
+    pool.set("lowlevel.zerocrossingrate.compute", true);    // {false,true}                     | zerocrossingrate
+    pool.set("lowlevel.mfcc.compute", true);                // {false,true}                     | mfcc, always computed for segmentation
+    pool.set("lowlevel.spectral_decrease.compute", true);   // {false,true}                     | spectral_decrease
+    pool.set("lowlevel.spectral_energy.compute", true);     // {false,true}                     | spectral_energy
+    pool.set("lowlevel.spectral_energyband.compute", true); // {false,true}                     | spectral_energyband_low/middle_low/middle_high/high
+    pool.set("lowlevel.hfc.compute", true);                 // {false,true}                     | hfc
+    pool.set("lowlevel.frequency_bands.compute", true);     // {false,true}                     | frequency_bands
+    pool.set("lowlevel.spectral_rms.compute", true);        // {false,true}                     | spectral_rms
+    pool.set("lowlevel.spectral_flux.compute", true);       // {false,true}                     | spectral_flux
+    pool.set("lowlevel.spectral_rolloff.compute", true);    // {false,true}                     | spectral_rolloff
+    pool.set("lowlevel.spectral_strongpeak.compute", true); // {false,true}                     | spectral_strongpeak
+    pool.set("lowlevel.barkbands.compute", true);           // {false,true}                     | barkbands
+    pool.set("lowlevel.spectral_crest.compute", true);      // {false,true}                     | spectral_crest
+    pool.set("lowlevel.spectral_flatness_db.compute", true); // {false,true}                    | spectral_flatness_db
+    pool.set("lowlevel.barkbands_moments.compute", true);   // {false,true}                     | barkbands_kurtosis/spread/skewness
+    pool.set("lowlevel.spectral_complexity.compute", true); // {false,true}                     | spectral_complexity
+    pool.set("lowlevel.pitch.compute", true);               // {false,true}                     | pitch and pitch_instantaneous_confidence, always computed for sfx
+    pool.set("lowlevel.pitch_salience.compute", true);      // {false,true}                     | pitch_salience
+
     // tonal
     pool.set("tonal.compute", false);                       // {false,true}                     | compute some tonal things
     pool.set("tonal.frameSize", 4096);                      // [1,inf)                          | the size of the frame to cut
@@ -203,6 +226,15 @@ typedef void (*free_audio_buffer_fct)(audio_buffer* buffer);
  */
 typedef void (*progress_fct)(float progress);
 
+/**
+ * @brief frame_sink_fct Callback receiving the frames of a descriptor while they are computed.
+ * @param descriptor_id The id returned by essentia_set_frame_sink.
+ * @param timestamp The time of the frame in seconds from the start of the analyzed audio.
+ * @param data The values of the frame, only valid during the call.
+ * @param dims The number of values, 1 for descriptors with a single value per frame.
+ */
+typedef void (*frame_sink_fct)(uint32_t descriptor_id, double timestamp, const float* data, uint32_t dims);
+
 /**
  * @brief The callbacks struct is used to handle all client callbacks.
  */
@@ -311,6 +343,185 @@ ESSENTIA_WRAPPER_API essentia_timestamps* essentia_analyze(callbacks* cb, uint32
  */
 ESSENTIA_WRAPPER_API void free_essentia_timestamps(essentia_timestamps* ts);
 
+/**
+ * @brief The essentia_plan struct is an analysis compiled for a fixed configuration.
+ *
+ * The streaming networks of a plan are built and validated once and reused for every
+ * file analyzed with it, so batches of short files do not pay the graph construction
+ * on each call. A plan must not be used by more than one thread at a time.
+ */
+struct essentia_plan;
+
+/**
+ * @brief essentia_plan_create Compiles the current configuration into an analysis plan.
+ *
+ * Later changes of the configuration do not affect the created plan.
+ *
+ * @return The plan or nullptr if the configuration is invalid.
+ */
+ESSENTIA_WRAPPER_API essentia_plan* essentia_plan_create();
+
+/**
+ * @brief essentia_plan_analyze Analyzes one file with a compiled plan.
+ * @param plan The plan created by essentia_plan_create.
+ * @param cb The filled callback struct of the file.
+ * @param count The count of the returned timestamps.
+ * @return An array of timestamps, to be freed with free_essentia_timestamps.
+ */
+ESSENTIA_WRAPPER_API essentia_timestamps* essentia_plan_analyze(essentia_plan* plan, callbacks* cb, uint32_t *count);
+
+/**
+ * @brief essentia_plan_get_timestamps Copies one timestamp series of the last file analyzed
+ * with a plan to a buffer of the caller.
+ *
+ * Called with a nullptr buffer, it only returns the count, so the buffer can be allocated
+ * with the exact size before the second call.
+ *
+ * @param plan The plan created by essentia_plan_create.
+ * @param type The series.
+ * @param buffer The buffer to fill, or nullptr.
+ * @param capacity The number of floats the buffer can hold.
+ * @return The count of values of the series, at most @e capacity of them are copied.
+ */
+ESSENTIA_WRAPPER_API uint32_t essentia_plan_get_timestamps(essentia_plan* plan, essentia_ts_type type, float* buffer, uint32_t capacity);
+
+/**
+ * @brief essentia_plan_destroy Frees a plan created by essentia_plan_create.
+ * @param plan The plan.
+ */
+ESSENTIA_WRAPPER_API void essentia_plan_destroy(essentia_plan* plan);
+
+/**
+ * @brief essentia_flush_output Waits until the output files queued with outputAsync are written.
+ * @return false if writing an output file failed since the last flush.
+ */
+ESSENTIA_WRAPPER_API bool essentia_flush_output();
+
+/**
+ * @brief malloc_fct Callback allocating memory for the wrapper, aligned for any type.
+ * @param size The size in bytes.
+ * @param ctx The context given to essentia_set_allocator.
+ * @return The memory or nullptr if it cannot be allocated.
+ */
+typedef void* (*malloc_fct)(size_t size, void* ctx);
+
+/**
+ * @brief free_fct Callback freeing memory allocated by malloc_fct.
+ * @param ptr The memory.
+ * @param ctx The context given to essentia_set_allocator.
+ */
+typedef void (*free_fct)(void* ptr, void* ctx);
+
+/**
+ * @brief essentia_set_allocator Sets the allocator of the memory the wrapper holds per analysis.
+ *
+ * It covers the returned timestamps, the frames, peaks and result matrices kept for the whole
+ * file, which grow with the length of the audio. The pools of essentia and the small objects
+ * still use the global heap, and the pools hold most of the memory of an analysis: resetting an
+ * arena does not release an analysis, free its results and plans for that. Every block is freed with the allocator it was allocated with, so
+ * the allocator can be changed between analyses; an arena may only be reset after the timestamps,
+ * plans and results allocated from it are freed. It is thread safe, but set it between analyses,
+ * an analysis running meanwhile takes its next blocks from the new allocator.
+ *
+ * @param malloc_fn The allocation callback, nullptr with free_fn to use malloc and free again.
+ * @param free_fn The free callback.
+ * @param ctx Passed to both callbacks.
+ * @return false if only one of the callbacks is nullptr.
+ */
+ESSENTIA_WRAPPER_API bool essentia_set_allocator(malloc_fct malloc_fn, free_fct free_fn, void* ctx);
+
+/**
+ * @brief essentia_set_frame_sink Passes the frames of a descriptor to the host instead of keeping them.
+ *
+ * The frame descriptors, e.g. "lowlevel.mfcc" or "tonal.hpcp", are received while they are
+ * computed. Their frames are only kept when the analysis needs them: when the configured
+ * statistics cannot be computed while streaming and for the MFCC of the segmentation. With the
+ * default statistics, the memory of long recordings stays bounded. The sinks are taken when a plan builds its networks, set
+ * them before essentia_plan_create or essentia_analyze. The sink is called on the analysis thread.
+ *
+ * @param name The full descriptor name.
+ * @param sink The callback, or nullptr to remove the sink of the descriptor.
+ * @return The descriptor id passed to the sink, UINT32_MAX if name is nullptr.
+ */
+ESSENTIA_WRAPPER_API uint32_t essentia_set_frame_sink(const char* name, frame_sink_fct sink);
+
+/**
+ * @brief The essentia_results struct is a handle to the aggregated results of one analysis.
+ *
+ * It holds every descriptor as it is written to the output files, e.g. "lowlevel.mfcc.mean",
+ * without writing and parsing them. The values are read in place and stay valid until the
+ * handle is destroyed, also when the plan analyzes the next files.
+ */
+struct essentia_results;
+
+/**
+ * @brief The essentia_shape struct is the shape of a descriptor returned by essentia_results_get.
+ */
+struct essentia_shape
+{
+    uint32_t rank;    //!< 0 for a single value, 1 for a vector, 2 for a matrix
+    uint32_t dims[2]; //!< the size of the dimensions, 0 for the unused ones
+};
+
+/**
+ * @brief essentia_analyze_results Analyzes a file like essentia_analyze and returns all the results.
+ * @param cb The filled callback struct
+ * @return The results, to be freed with essentia_results_destroy, or nullptr if the analysis failed.
+ */
+ESSENTIA_WRAPPER_API essentia_results* essentia_analyze_results(callbacks* cb);
+
+/**
+ * @brief essentia_plan_results The results of the last file analyzed with a plan.
+ * @param plan The plan created by essentia_plan_create.
+ * @return The results, to be freed with essentia_results_destroy, or nullptr if no file was analyzed.
+ */
+ESSENTIA_WRAPPER_API essentia_results* essentia_plan_results(essentia_plan* plan);
+
+/**
+ * @brief essentia_results_get Looks up a real descriptor.
+ *
+ * Matrices are stored by rows, they are made contiguous on their first lookup and kept
+ * in the handle.
+ *
+ * @param results The results.
+ * @param name The full descriptor name, e.g. "lowlevel.mfcc.mean".
+ * @param data Set to the values, row major, owned by the handle.
+ * @param shape Set to the shape of the values.
+ * @return false if there is no real descriptor @e name or its rows have different lengths.
+ */
+ESSENTIA_WRAPPER_API bool essentia_results_get(essentia_results* results, const char* name, const float** data, essentia_shape* shape);
+
+/**
+ * @brief essentia_results_get_string Looks up a string descriptor.
+ * @param results The results.
+ * @param name The full descriptor name, e.g. "tonal.key_key".
+ * @param index The string of a string vector, 0 for single strings.
+ * @param value Set to the string, owned by the handle.
+ * @param count Set to the number of strings of the descriptor, can be nullptr.
+ * @return false if there is no string descriptor @e name or @e index is out of range.
+ */
+ESSENTIA_WRAPPER_API bool essentia_results_get_string(essentia_results* results, const char* name, uint32_t index, const char** value, uint32_t* count);
+
+/**
+ * @brief essentia_results_count The number of descriptors of the results.
+ * @param results The results.
+ */
+ESSENTIA_WRAPPER_API uint32_t essentia_results_count(essentia_results* results);
+
+/**
+ * @brief essentia_results_name The name of a descriptor, the names are sorted.
+ * @param results The results.
+ * @param index The descriptor, from 0 to essentia_results_count - 1.
+ * @return The name, owned by the handle, or nullptr if @e index is out of range.
+ */
+ESSENTIA_WRAPPER_API const char* essentia_results_name(essentia_results* results, uint32_t index);
+
+/**
+ * @brief essentia_results_destroy Frees the results.
+ * @param results The results.
+ */
+ESSENTIA_WRAPPER_API void essentia_results_destroy(essentia_results* results);
+
 #ifdef __cplusplus
 }
 #endif